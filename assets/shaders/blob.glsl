@@ -0,0 +1,20 @@
+VERT
+uniform mat4 u_Matrix;
+attribute vec3 v_vertex;
+attribute vec2 v_coord;
+varying vec2 v_Coords;
+void main()
+{
+    v_Coords = v_coord * 2.0 - 1.0;
+    gl_Position = u_Matrix * vec4(v_vertex, 1.0);
+}
+END
+
+FRAG
+varying vec2 v_Coords;
+void main()
+{
+  vec2 edge = 1.0 - v_Coords * v_Coords;
+  gl_FragColor = vec4(0.25, 0.25, 0.25, 0.5) * edge.x * edge.y;
+}
+END
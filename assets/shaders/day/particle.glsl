@@ -0,0 +1,26 @@
+VERT
+uniform mat4 u_Matrix;
+uniform vec3 u_Particles[64];
+uniform vec4 u_Frame;
+attribute vec3 v_vertex;
+attribute vec2 v_coord;
+varying vec2 v_Coords;
+void main()
+{
+    v_Coords = v_coord * u_Frame.xy + u_Frame.zw;
+    gl_Position = u_Matrix * vec4(u_Particles[int(v_vertex.x)], 1.0);
+    gl_Position.xy += 2.0 * (v_coord.xy * 1.0 - 0.5);
+    gl_Position.y += 0.25;
+}
+END
+
+FRAG
+uniform sampler2D color_texture;
+uniform vec4 u_FrameBounds;
+varying vec2 v_Coords;
+void main()
+{
+    gl_FragColor = texture2D(color_texture, clamp(v_Coords, u_FrameBounds.xy, u_FrameBounds.zw));
+    gl_FragColor.a *= 0.15;
+}
+END
\ No newline at end of file
@@ -1,23 +1,25 @@
 VERT
 uniform mat4 u_Matrix;
+uniform vec4 u_Frame;
 attribute vec3 v_vertex;
 attribute vec2 v_coord;
 varying vec2 v_Coords;
 
 void main()
 {
-    v_Coords = v_coord;
+    v_Coords = v_coord * u_Frame.xy + u_Frame.zw;
     gl_Position = u_Matrix * vec4(v_vertex, 1.0);
 }
 END
 
 FRAG
 uniform sampler2D color_texture;
+uniform vec4 u_FrameBounds;
 varying vec2 v_Coords;
 
 void main()
 {
-  gl_FragColor = texture2D(color_texture, v_Coords);
+  gl_FragColor = texture2D(color_texture, clamp(v_Coords, u_FrameBounds.xy, u_FrameBounds.zw));
   if (gl_FragColor.a < 0.1) discard;
 }
 END
\ No newline at end of file
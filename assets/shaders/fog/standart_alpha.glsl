@@ -1,6 +1,7 @@
 VERT
 uniform mat4 u_ModelViewMatrix;
 uniform mat4 u_ProjectionMatrix;
+uniform vec4 u_Frame;
 attribute vec3 v_vertex;
 attribute vec3 v_normal;
 attribute vec2 v_coord;
@@ -13,13 +14,14 @@ void main()
     vec4 view_pos = u_ModelViewMatrix * vec4(v_vertex, 1.0);
     v_Normal = (u_ModelViewMatrix * vec4(v_normal, 0.0)).xyz;
     v_Vertex = view_pos.xyz;
-    v_Coords = v_coord;
+    v_Coords = v_coord * u_Frame.xy + u_Frame.zw;
     gl_Position = u_ProjectionMatrix * view_pos;
 }
 END
 
 FRAG
 uniform sampler2D color_texture;
+uniform vec4 u_FrameBounds;
 varying vec3 v_Vertex;
 varying vec3 v_Normal;
 varying vec2 v_Coords;
@@ -28,7 +30,7 @@ vec3 one = vec3(1.0, 1.0, 1.0);
 
 void main()
 {
-  vec4 diffuse = texture2D(color_texture, v_Coords);
+  vec4 diffuse = texture2D(color_texture, clamp(v_Coords, u_FrameBounds.xy, u_FrameBounds.zw));
   if (diffuse.a < 0.1) discard;
   vec3 N = normalize(v_Normal - 0.5 + 1.0 * diffuse.rgb);
   vec3 R = normalize(-reflect(-v_Vertex, N));
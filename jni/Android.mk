@@ -29,6 +29,7 @@ LOCAL_PATH := ../support/bullet3-2.83.7
 include $(CLEAR_VARS)
 
 LOCAL_MODULE    := libbullet
+LOCAL_CFLAGS := -DBT_NO_PROFILE
 FILE_LIST := $(wildcard $(LOCAL_PATH)/BulletCollision/**/*.cpp)
 FILE_LIST += $(wildcard $(LOCAL_PATH)/BulletDynamics/**/*.cpp)
 FILE_LIST += $(wildcard $(LOCAL_PATH)/LinearMath/*.cpp)
@@ -43,7 +44,7 @@ LOCAL_PATH := .
 
 LOCAL_MODULE := open4speed
 
-LOCAL_CFLAGS := -DANDROID_NDK
+LOCAL_CFLAGS := -DANDROID_NDK -DBT_NO_PROFILE
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH) \
 $(LOCAL_PATH)/../support/libpng-1.6.3 \
@@ -55,11 +56,12 @@ $(LOCAL_PATH)/../support/glm-0.9.5.4
 FILE_LIST := $(wildcard $(LOCAL_PATH)/engine/*.cpp)
 FILE_LIST += $(wildcard $(LOCAL_PATH)/files/*.cpp)
 FILE_LIST += $(wildcard $(LOCAL_PATH)/input/*.cpp)
+FILE_LIST += $(wildcard $(LOCAL_PATH)/renderers/null/*.cpp)
 FILE_LIST += $(wildcard $(LOCAL_PATH)/renderers/opengl/*.cpp)
-FILE_LIST += physics/bullet/bullet.cpp open4speed.cpp
+FILE_LIST += physics/bullet/batchraycaster.cpp physics/bullet/bullet.cpp physics/bullet/parallelworld.cpp open4speed.cpp
 LOCAL_SRC_FILES := $(FILE_LIST:$(LOCAL_PATH)/%=%)
 
-LOCAL_LDLIBS := -lGLESv2 -ldl -llog -landroid -lz
+LOCAL_LDLIBS := -lEGL -lGLESv2 -ldl -llog -landroid -lz
 
 LOCAL_STATIC_LIBRARIES := libpng \ libbullet \ libzip
 
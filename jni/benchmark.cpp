@@ -0,0 +1,331 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       benchmark.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Headless benchmark running the simulation without graphical context.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "engine/profiler.h"
+#include "engine/scene.h"
+#include "physics/bullet/parallelworld.h"
+
+#define BENCHMARK_HEIGHT 640
+#define BENCHMARK_ISLAND_STEPS 300
+#define BENCHMARK_ISLAND_TOLERANCE 0.0001f
+#define BENCHMARK_MATRIX_ROUNDS 100
+#define BENCHMARK_TICKS 1000
+#define BENCHMARK_TRACK "#assets/tracks/winter-day.o4scfg"
+#define BENCHMARK_WIDTH 960
+
+/**
+ * @brief matrixBenchmark compares generic matrix path of draw call with affine, batch and
+ * static path, it uses the same matrices as scene rendering does
+ * @param count is amount of model matrices
+ */
+void matrixBenchmark(int count)
+{
+    /// prepare matrices
+    glm::mat4x4 proj = glm::perspective(1.0f, 1.5f, 0.1f, 500.0f);
+    glm::mat4x4 view = glm::lookAt(glm::vec3(10, 5, 10), glm::vec3(0), glm::vec3(0, 1, 0));
+    std::vector<glm::mat4x4> models(count);
+    std::vector<glm::vec3> offsets(count);
+    std::vector<glm::mat4x4> generic(count);
+    std::vector<glm::mat4x4> affine(count);
+    unsigned int seed = 1;
+    for (int i = 0; i < count; i++)
+    {
+        float angle = randomInt(seed) * 0.001f;
+        models[i] = glm::rotate(glm::translate(glm::mat4x4(1), glm::vec3(i, 0, -i)), angle, glm::vec3(0, 1, 0));
+        offsets[i] = glm::vec3(randomInt(seed) % 10, randomInt(seed) % 10, randomInt(seed) % 10);
+    }
+
+    /// matrices which are sent to shader are summed so compiler does not skip them
+    volatile float used = 0;
+
+    /// generic path builds translation and multiplies four times per draw
+    double time = getTime();
+    for (int r = 0; r < BENCHMARK_MATRIX_ROUNDS; r++)
+        for (int i = 0; i < count; i++)
+        {
+            glm::mat4x4 translation(1);
+            translation[3] = glm::vec4(offsets[i], 1);
+            glm::mat4x4 modelMat = models[i] * translation;
+            glm::mat4x4 modelView = view * modelMat;
+            glm::mat4x4 projView = proj * view;
+            generic[i] = proj * modelView;
+            used = used + modelView[0][0] + projView[0][0];
+        }
+    double genericTime = getTime() - time;
+
+    /// affine path adds translation into column and uses cached projection view matrix
+    time = getTime();
+    glm::mat4x4 projView;
+    matrices::multiply(glm::value_ptr(proj), glm::value_ptr(view), glm::value_ptr(projView));
+    for (int r = 0; r < BENCHMARK_MATRIX_ROUNDS; r++)
+        for (int i = 0; i < count; i++)
+        {
+            glm::mat4x4 modelMat = models[i];
+            modelMat[3] += modelMat[0] * offsets[i].x + modelMat[1] * offsets[i].y + modelMat[2] * offsets[i].z;
+            glm::mat4x4 modelView;
+            matrices::multiply(glm::value_ptr(view), glm::value_ptr(modelMat), glm::value_ptr(modelView));
+            matrices::multiply(glm::value_ptr(projView), glm::value_ptr(modelMat), glm::value_ptr(affine[i]));
+            used = used + modelView[0][0] + projView[0][0];
+        }
+    double affineTime = getTime() - time;
+
+    /// static path of track parts changes only position column of per frame matrices
+    std::vector<glm::mat4x4> fixed(count);
+    time = getTime();
+    for (int r = 0; r < BENCHMARK_MATRIX_ROUNDS; r++)
+        for (int i = 0; i < count; i++)
+        {
+            glm::vec4 position = glm::vec4(offsets[i], 1);
+            glm::mat4x4 modelView = view;
+            modelView[3] = view * position;
+            fixed[i] = projView;
+            fixed[i][3] = projView * position;
+            used = used + modelView[0][0];
+        }
+    double staticTime = getTime() - time;
+
+    /// batch path counts all matrices of frame in one pass
+    for (int i = 0; i < count; i++)
+        models[i][3] += models[i][0] * offsets[i].x + models[i][1] * offsets[i].y + models[i][2] * offsets[i].z;
+    time = getTime();
+    for (int r = 0; r < BENCHMARK_MATRIX_ROUNDS; r++)
+        matrices::multiply(glm::value_ptr(projView), glm::value_ptr(models[0]), glm::value_ptr(affine[0]), count);
+    double batchTime = getTime() - time;
+
+    /// compare results
+    float difference = 0;
+    for (int i = 0; i < count; i++)
+        for (int j = 0; j < 4; j++)
+            for (int k = 0; k < 4; k++)
+                difference = glm::max(difference, fabsf(generic[i][j][k] - affine[i][j][k]));
+    printf("matrices         %d per frame\n", count);
+    printf("  generic        %.4f ms/frame\n", genericTime / BENCHMARK_MATRIX_ROUNDS);
+    printf("  affine         %.4f ms/frame\n", affineTime / BENCHMARK_MATRIX_ROUNDS);
+    printf("  batch          %.4f ms/frame\n", batchTime / BENCHMARK_MATRIX_ROUNDS);
+    printf("  static         %.4f ms/frame\n", staticTime / BENCHMARK_MATRIX_ROUNDS);
+    printf("  difference     %g\n", difference);
+}
+
+/**
+ * @brief islandTest simulates many independent islands in serial and in parallel mode and
+ * compares their results, every second island has a constraint
+ * @param count is amount of islands
+ * @param threads is amount of threads in parallel mode
+ * @return true if parallel mode gives the same result as serial mode
+ */
+bool islandTest(int count, int threads)
+{
+    std::vector<btVector3> results[2];
+    double times[2];
+    for (int pass = 0; pass < 2; pass++)
+    {
+        /// world with ground plane, boxes are far enough to stay in their own islands
+        btDefaultCollisionConfiguration config;
+        btCollisionDispatcher dispatcher(&config);
+        btDbvtBroadphase broadphase;
+        btSequentialImpulseConstraintSolver solver;
+        parallelworld world(&dispatcher, &broadphase, &solver, &config);
+        world.setThreads(pass == 0 ? 1 : threads);
+        btStaticPlaneShape plane(btVector3(0, 1, 0), 0);
+        btRigidBody ground(0, 0, &plane);
+        world.addRigidBody(&ground);
+        btBoxShape box(btVector3(0.5f, 0.5f, 0.5f));
+        btVector3 inertia;
+        box.calculateLocalInertia(1, inertia);
+        std::vector<btRigidBody*> bodies;
+        std::vector<btTypedConstraint*> constraints;
+        int side = (int)sqrt((float)count) + 1;
+        for (int i = 0; i < count; i++)
+        {
+            btTransform transform;
+            transform.setIdentity();
+            transform.setOrigin(btVector3((i % side) * 4.0f, 1.0f + (i % 3), (i / side) * 4.0f));
+            transform.setRotation(btQuaternion(btVector3(1, 0, 1), i * 0.1f));
+            btRigidBody* body = new btRigidBody(1, 0, &box, inertia);
+            body->setWorldTransform(transform);
+            world.addRigidBody(body);
+            bodies.push_back(body);
+            if (i % 2 == 1)
+            {
+                btPoint2PointConstraint* pin = new btPoint2PointConstraint(*body, btVector3(0.5f, 0.5f, 0.5f));
+                world.addConstraint(pin);
+                constraints.push_back(pin);
+            }
+        }
+
+        /// simulate
+        double time = getTime();
+        for (int i = 0; i < BENCHMARK_ISLAND_STEPS; i++)
+            world.stepSimulation(1 / 60.0f, 1, 1 / 60.0f);
+        times[pass] = getTime() - time;
+
+        /// store result and clean up
+        for (unsigned int i = 0; i < constraints.size(); i++)
+        {
+            world.removeConstraint(constraints[i]);
+            delete constraints[i];
+        }
+        for (unsigned int i = 0; i < bodies.size(); i++)
+        {
+            results[pass].push_back(bodies[i]->getWorldTransform().getOrigin());
+            world.removeRigidBody(bodies[i]);
+            delete bodies[i];
+        }
+        world.removeRigidBody(&ground);
+    }
+
+    /// compare results
+    float difference = 0;
+    for (int i = 0; i < count; i++)
+        difference = glm::max(difference, (results[0][i] - results[1][i]).length());
+    bool ok = difference <= BENCHMARK_ISLAND_TOLERANCE;
+    printf("islands          %d\n", count);
+    printf("  serial         %.3f ms/step\n", times[0] / BENCHMARK_ISLAND_STEPS);
+    printf("  %d threads      %.3f ms/step\n", threads, times[1] / BENCHMARK_ISLAND_STEPS);
+    printf("  difference     %g\n", difference);
+    printf("  result         %s\n", ok ? "ok" : "failed");
+    return ok;
+}
+
+/**
+ * @brief main runs scene for given amount of ticks as fast as possible and prints
+ * measured times
+ * @param argc is amount of arguments
+ * @param argv is array of arguments
+ * @return exit code
+ */
+int main(int argc, char** argv)
+{
+    /// read arguments
+    std::string track = BENCHMARK_TRACK;
+    std::string replayFile = "";
+    std::string traceFile = "";
+    int ticks = BENCHMARK_TICKS;
+    int physicsThreads = 0;
+    bool aiThread = false;
+    int matrixCount = 0;
+    int islandCount = 0;
+    int shadowMode = SHADOW_VOLUME;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--track") == 0) && (i + 1 < argc))
+            track = argv[++i];
+        else if ((strcmp(argv[i], "--ticks") == 0) && (i + 1 < argc))
+            ticks = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+            replayFile = argv[++i];
+        else if ((strcmp(argv[i], "--physics-threads") == 0) && (i + 1 < argc))
+            physicsThreads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--trace") == 0) && (i + 1 < argc))
+            traceFile = argv[++i];
+        else if (strcmp(argv[i], "--ai-thread") == 0)
+            aiThread = true;
+        else if (strcmp(argv[i], "--blob-shadows") == 0)
+            shadowMode = SHADOW_BLOB;
+        else if ((strcmp(argv[i], "--matrices") == 0) && (i + 1 < argc))
+            matrixCount = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--islands") == 0) && (i + 1 < argc))
+            islandCount = atoi(argv[++i]);
+        else
+        {
+            printf("Usage: %s [--track file] [--ticks count] [--replay file]\n", argv[0]);
+            printf("          [--physics-threads count] [--ai-thread] [--trace file]\n");
+            printf("          [--blob-shadows] [--matrices count] [--islands count]\n");
+            return 1;
+        }
+    }
+
+    /// microbenchmark of matrices does not need scene
+    if (matrixCount > 0)
+    {
+        matrixBenchmark(matrixCount);
+        return 0;
+    }
+
+    /// test of parallel island solving does not need scene
+    if (islandCount > 0)
+        return islandTest(islandCount, physicsThreads > 1 ? physicsThreads : PARALLEL_MAX_THREADS) ? 0 : 1;
+
+    /// load scene
+    double time = getTime();
+    scene* scn = new scene(track, true);
+    scn->initRenderer(BENCHMARK_WIDTH, BENCHMARK_HEIGHT, 1);
+    if (physicsThreads > 0)
+        scn->setPhysicsThreads(physicsThreads);
+    if (aiThread)
+        scn->setThreadedAI(true);
+    scn->setShadowMode(shadowMode);
+    if (replayFile.empty() || !scn->replayInput(replayFile))
+        scn->setDeterministic(true);
+    scn->setPhysicsLocked(false);
+    double loading = getTime() - time;
+
+    /// run simulation
+    double update = 0;
+    double render = 0;
+    frameLog frames = frameLog();
+    double start = getTime();
+    for (int i = 0; i < ticks; i++)
+    {
+        time = getTime();
+        scn->update();
+        update += getTime() - time;
+        time = getTime();
+        scn->render(0);
+        render += getTime() - time;
+
+        /// sum draw calls of frames
+        frameLog f = scn->getFrameLog();
+        frames.drawCalls += f.drawCalls;
+        frames.triangles += f.triangles;
+        frames.bytes += f.bytes;
+        frames.shaderBinds += f.shaderBinds;
+        frames.textureBinds += f.textureBinds;
+        frames.stateChanges += f.stateChanges;
+    }
+    double total = getTime() - start;
+
+    /// print results
+    lodCounter full = scn->getLodCounter(LOD_FULL);
+    lodCounter kinematic = scn->getLodCounter(LOD_KINEMATIC);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("track            %s\n", track.c_str());
+    printf("ticks            %d\n", ticks);
+    printf("loading          %.1f ms\n", loading);
+    printf("ticks per second %.1f\n", ticks * 1000.0 / total);
+    printf("update           %.3f ms/tick\n", update / ticks);
+    printf("  cars simulated %.3f ms/tick\n", full.time / ticks);
+    printf("  cars kinematic %.3f ms/tick\n", kinematic.time / ticks);
+    printf("  world          %.3f ms/tick\n", (update - full.time - kinematic.time) / ticks);
+    printf("render           %.3f ms/tick\n", render / ticks);
+    printf("  draw calls     %.1f /frame\n", frames.drawCalls / (float)ticks);
+    printf("  triangles      %.1f /frame\n", frames.triangles / (float)ticks);
+    printf("  vertex data    %.1f kB/frame\n", frames.bytes / 1024.0f / ticks);
+    printf("  shader binds   %.1f /frame\n", frames.shaderBinds / (float)ticks);
+    printf("  texture binds  %.1f /frame\n", frames.textureBinds / (float)ticks);
+    printf("  state changes  %.1f /frame\n", frames.stateChanges / (float)ticks);
+    printf("peak memory      %ld kB\n", usage.ru_maxrss);
+    for (int i = 0; i < profiler::getSectionCount(); i++)
+    {
+        profileSection s = profiler::getSection(i);
+        printf("last frame       %s %.3f ms (%dx)\n", s.name, s.time, s.count);
+    }
+    if (!traceFile.empty() && !profiler::exportTrace(traceFile))
+        printf("unable to write %s\n", traceFile.c_str());
+    delete scn;
+    return 0;
+}
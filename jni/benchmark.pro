@@ -0,0 +1,83 @@
+# -------------------------------------------------
+# Headless benchmark, it is built without OpenGL and runs without window
+# -------------------------------------------------
+LIBS += -lpthread \
+    -lpng \
+    -lzip
+TARGET = benchmark
+CONFIG += console
+CONFIG -= app_bundle
+TEMPLATE = app
+SOURCES += \
+    ../support/bullet3-2.83.7/BulletCollision/BroadphaseCollision/*.cpp \
+    ../support/bullet3-2.83.7/BulletCollision/CollisionDispatch/*.cpp \
+    ../support/bullet3-2.83.7/BulletCollision/CollisionShapes/*.cpp \
+    ../support/bullet3-2.83.7/BulletCollision/Gimpact/*.cpp \
+    ../support/bullet3-2.83.7/BulletCollision/NarrowPhaseCollision/*.cpp \
+    ../support/bullet3-2.83.7/BulletDynamics/ConstraintSolver/*.cpp \
+    ../support/bullet3-2.83.7/BulletDynamics/Dynamics/*.cpp \
+    ../support/bullet3-2.83.7/BulletDynamics/Featherstone/*.cpp \
+    ../support/bullet3-2.83.7/BulletDynamics/Character/*.cpp \
+    ../support/bullet3-2.83.7/BulletDynamics/MLCPSolvers/*.cpp \
+    ../support/bullet3-2.83.7/BulletDynamics/Vehicle/*.cpp \
+    ../support/bullet3-2.83.7/LinearMath/*.cpp \
+    engine/car.cpp \
+    engine/io.cpp \
+    engine/math.cpp \
+    engine/matrices.cpp \
+    engine/model.cpp \
+    engine/particles.cpp \
+    engine/profiler.cpp \
+    engine/renderstate.cpp \
+    engine/resolution.cpp \
+    engine/scene.cpp \
+    engine/scheduler.cpp \
+    engine/track.cpp \
+    files/extfile.cpp \
+    files/pngdecoder.cpp \
+    files/zipfile.cpp \
+    input/aigroup.cpp \
+    input/airacer.cpp \
+    input/recorder.cpp \
+    input/replay.cpp \
+    physics/bullet/batchraycaster.cpp \
+    physics/bullet/bullet.cpp \
+    physics/bullet/parallelworld.cpp \
+    renderers/null/nullrenderer.cpp \
+    benchmark.cpp
+HEADERS += \
+    engine/car.h \
+    engine/io.h \
+    engine/math.h \
+    engine/matrices.h \
+    engine/model.h \
+    engine/particles.h \
+    engine/profiler.h \
+    engine/renderstate.h \
+    engine/resolution.h \
+    engine/scene.h \
+    engine/scheduler.h \
+    engine/track.h \
+    files/extfile.h \
+    files/pngdecoder.h \
+    files/zipfile.h \
+    input/aigroup.h \
+    input/airacer.h \
+    input/recorder.h \
+    input/replay.h \
+    interfaces/file.h \
+    interfaces/input.h \
+    interfaces/materialLoader.h \
+    interfaces/physics.h \
+    interfaces/renderer.h \
+    interfaces/shader.h \
+    interfaces/texture.h \
+    physics/bullet/batchraycaster.h \
+    physics/bullet/bullet.h \
+    physics/bullet/parallelworld.h \
+    renderers/null/nullrenderer.h \
+    renderers/null/nullshader.h \
+    renderers/null/nulltexture.h
+INCLUDEPATH += ../support/bullet3-2.83.7
+DEFINES += BT_NO_PROFILE \
+    HEADLESS_ONLY
@@ -15,7 +15,6 @@
 #define PERSPECTIVE_MAX 150
 #define PERSPECTIVE_SPEED_DEPENDENCY 0.2
 #define PERSPECTIVE_SPEED_FOLLOW 2
-#define SPEED_ASPECT 50
 #define SOUND_CRASH_MINIMAL_SPEED 5
 #define SOUND_CRASH_ON_SPEED_CHANGE 0.7
 #define SOUND_ENGINE_FREQ_ASPECT 15
@@ -24,12 +23,12 @@
 /**
  * @brief car is constructor which loads car model
  * @param i is car control device(or program)
- * @param e is curve which car may take on
+ * @param e is track graph which car may take on
  * @param filename is path to file to load
  * @param skin is car skin model
  * @param wheel is car wheel model
  */
-car::car(input *i, std::vector<edge> *e, std::string filename, model* skin, model* wheel)
+car::car(input *i, const track *e, std::string filename, model* skin, model* wheel)
 {
     /// get car atributes
     std::vector<std::string> atributes = getList("", filename);
@@ -43,7 +42,9 @@ car::car(input *i, std::vector<edge> *e, std::string filename, model* skin, mode
     onRoof = 0;
     extraSound = 0;
     control = i;
-    edges = *e;
+    edges = e;
+    currentEdge = 0;
+    currentGoalEdge = 0;
     prevEffect = 0;
     rot = 0;
     speed = 0;
@@ -51,6 +52,8 @@ car::car(input *i, std::vector<edge> *e, std::string filename, model* skin, mode
     reverse = false;
     resetAllowed = false;
     resetRequested = false;
+    kinematic = false;
+    lapsToGo = 0;
     toFinish = 0;
 
     /// create matrices
@@ -118,12 +121,17 @@ float car::getView()
 
 /**
  * @brief setStart sets start position of car
- * @param e is curve where car starts on
+ * @param e is index of edge where car starts on
+ * @param sidemove is side distance from edge
  */
-void car::setStart(edge e, float sidemove)
+void car::setStart(int e, float sidemove)
 {
     /// error check
-    if ((e.a.x == e.b.x) && (e.a.z == e.b.z))
+    if ((e < 0) || (e >= edges->getEdgeCount()))
+        return;
+    glm::vec3 a = edges->getStart(e);
+    glm::vec3 b = edges->getEnd(e);
+    if ((a.x == b.x) && (a.z == b.z))
         return;
 
     /// set edges
@@ -133,34 +141,14 @@ void car::setStart(edge e, float sidemove)
     /// set transformation
     resetAllowed = false;
     reverse = false;
-    rot = angle(currentEdge.a, currentEdge.b);
-    oldPos.x = pos.x = currentEdge.a.x + cos(rot) * sidemove;
-    oldPos.y = pos.y = currentEdge.a.y;
-    oldPos.z = pos.z = currentEdge.a.z + sin(rot) * sidemove;
+    rot = angle(a, b);
+    oldPos.x = pos.x = a.x + cos(rot) * sidemove;
+    oldPos.y = pos.y = a.y;
+    oldPos.z = pos.z = a.z + sin(rot) * sidemove;
     rot = rot * 180 / 3.14 - 180;
 
     /// count distance from finish
-    int ltg = lapsToGo;
-    if (ltg < 0)
-    {
-        toFinish = 0;
-        return;
-    }
-    edge cge = currentGoalEdge;
-    toFinish = glm::length(cge.a - cge.b);
-    while (true) {
-        toFinish += glm::length(cge.a - cge.b);
-        std::vector<int> nEdges = nextEdge(edges, cge);
-        if (nEdges.size() > 0)
-        {
-            cge = edges[nEdges[0]];
-            if ((ltg > 0) & (nEdges[0] == finishEdge))
-                ltg--;
-            else if ((ltg == 0) & (nEdges[0] == finishEdge))
-                break;
-        } else
-            break;
-    }
+    updateProgress();
 }
 
 
@@ -176,32 +164,28 @@ void car::update(float dst2camera)
     float dz = oldPos.z - pos.z;
     speed = sqrt(dx * dx + dz * dz) * SPEED_ASPECT;
 
-    /// update current edge for counting laps
-    edge cge = currentGoalEdge;
-    if (distance(pos, currentGoalEdge.b) < 75)
+    /// update current edge for counting laps, track without edges has no laps
+    if (edges->getEdgeCount() > 0)
     {
-        std::vector<int> nEdges = nextEdge(edges, currentGoalEdge);
-        if (nEdges.size() > 0)
+        glm::vec3 end = edges->getEnd(currentGoalEdge);
+        if (distance(pos, end) < 75)
         {
-            if (isSame(edges[nEdges[0]], edges[finishEdge]))
+            int next = edges->getNext(currentGoalEdge);
+            if (next >= 0)
             {
-                if (distance(pos, currentGoalEdge.b) < 50)
+                if (edges->isSame(next, edges->getFinish()))
                 {
-                    toFinish -= glm::length(cge.a - cge.b);
-                    currentEdgeIndex = nEdges[0];
-                    currentGoalEdge = edges[nEdges[0]];
-                    if ((lapsToGo >= 0) & (isSame(edges[nEdges[0]], edges[finishEdge])))
-                        lapsToGo--;
-                }
-            } else
-            {
-                toFinish -= glm::length(cge.a - cge.b);
-                currentEdgeIndex = nEdges[0];
-                currentGoalEdge = edges[nEdges[0]];
-                if ((lapsToGo >= 0) & (isSame(edges[nEdges[0]], edges[finishEdge])))
-                    lapsToGo--;
+                    if (distance(pos, end) < 50)
+                    {
+                        currentGoalEdge = next;
+                        if (lapsToGo >= 0)
+                            lapsToGo--;
+                    }
+                } else
+                    currentGoalEdge = next;
             }
         }
+        updateProgress();
     }
 
     /// store last position
@@ -291,3 +275,24 @@ void car::update(float dst2camera)
     sndEngine1 = 8.0 * (0.25f - extraSound);
     sndEngine2 = extraSound;
 }
+
+/**
+ * @brief updateProgress counts distance to finish from lap and position on current edge
+ */
+void car::updateProgress()
+{
+    /// project position on current edge
+    glm::vec3 a = edges->getStart(currentGoalEdge);
+    glm::vec3 b = edges->getEnd(currentGoalEdge);
+    float length = edges->getLength(currentGoalEdge);
+    float projection = 0;
+    if (length > 0)
+        projection = glm::clamp(glm::dot(pos - a, b - a) / length, 0.0f, length);
+
+    /// every lap starts by entering finish edge
+    float lap = edges->getLapLength();
+    float driven = edges->getDistance(currentGoalEdge);
+    if (driven < 0)
+        driven = 0;
+    toFinish = (lapsToGo + 1) * lap - driven - projection;
+}
@@ -12,9 +12,12 @@
 #define CAR_H
 
 #include <string>
+#include "engine/track.h"
 #include "interfaces/input.h"
 #include "model.h"
 
+#define SPEED_ASPECT 50
+
 /**
  * @brief The gear struct
  */
@@ -44,11 +47,9 @@ public:
     unsigned int currentGear;                                             ///< Current gear
     bool reverse;                                                         ///< Car direction
     input* control;                                                       ///< Car control device(or script)
-    edge currentEdge;                                                     ///< Current track part
-    int currentEdgeIndex;                                                 ///< Current position index
-    edge currentGoalEdge;                                                 ///< Current track part for counting laps
-    std::vector<edge> edges;                                              ///< Track for current car
-    int finishEdge;                                                       ///< Index of final edge
+    int currentEdge;                                                      ///< Current track part index
+    int currentGoalEdge;                                                  ///< Current track part index for counting laps
+    const track* edges;                                                   ///< Track graph shared by all cars
     int lapsToGo;                                                         ///< Amount of laps to go
     unsigned int index;                                                   ///< Index of car
     glm::vec3 pos, oldPos;                                                ///< Car position
@@ -60,6 +61,7 @@ public:
     float toFinish;                                                       ///< Distance to finish
     int onRoof;                                                           ///< Time when car is on roof(used for reseting)
     bool resetAllowed, resetRequested;                                    ///< Reset variables
+    bool kinematic;                                                       ///< Car is moved without simulation
     float n2o;                                                            ///< Amount of N2O
     float extraSound;                                                     ///< Amount of extra engine sound volume
     float prevEffect;                                                     ///< Previous smoke effect intensity
@@ -73,12 +75,12 @@ public:
     /**
      * @brief car is constructor which loads car model
      * @param i is car control device(or program)
-     * @param e is curve which car may take on
+     * @param e is track graph which car may take on
      * @param filename is path to file to load
      * @param skin is car skin model
      * @param wheel is car wheel model
      */
-    car(input *i, std::vector<edge> *e, std::string filename, model* skin, model* wheel);
+    car(input *i, const track *e, std::string filename, model* skin, model* wheel);
 
     /**
      * @brief getView gets perspective view of car
@@ -88,15 +90,21 @@ public:
 
     /**
      * @brief setStart sets start position of car
-     * @param e is curve where car starts on
+     * @param e is index of edge where car starts on
+     * @param sidemove is side distance from edge
      */
-    void setStart(edge e, float sidemove);
+    void setStart(int e, float sidemove);
 
     /**
      * @brief update updates car wheels state(rotation and steering)
      * @param dst2camera is distance to camera in meters
      */
     void update(float dst2camera);
+
+    /**
+     * @brief updateProgress counts distance to finish from lap and position on current edge
+     */
+    void updateProgress();
 };
 
 #endif // CAR_H
@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "engine/io.h"
 #include "files/extfile.h"
 #include "files/zipfile.h"
@@ -147,6 +148,17 @@ file* getFile(std::string filename)
     }
 }
 
+/**
+* @brief getTime gets monotonic time for measuring
+* @return time in milliseconds
+*/
+double getTime()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
 /**
 * @brief getList gets list of string from script file
 * @param tag is tag of script part
@@ -53,6 +53,12 @@ std::string getExtension(std::string filename);
  */
 file* getFile(std::string filename);
 
+/**
+ * @brief getTime gets monotonic time for measuring
+ * @return time in milliseconds
+ */
+double getTime();
+
 /**
  * @brief getListEx gets list of string from script file
  * @param tag is tag of script part
@@ -128,31 +128,12 @@ bool isSame(edge a, edge b)
 }
 
 /**
- * @brief nextEdge gets all possible indexes of next edges
- * @param edges is track curve instance
- * @param e is current edge
- * @return indicies as vector of int
+ * @brief randomInt gets pseudorandom number from local generator
+ * @param seed is state of generator, it is updated
+ * @return number from 0 to 32767
  */
-std::vector<int> nextEdge(std::vector<edge> edges, edge e)
+int randomInt(unsigned int& seed)
 {
-    std::vector<int> output;
-
-    /// skip logical edges
-    /*for (unsigned int i = 0; i < edges.size(); i++) {
-        if ((edges[i].a.x == e.b.x) && (edges[i].a.z == e.b.z)) {
-            if (e.b.y > edges[i].a.y) {
-                e.b.y = edges[i].a.y;
-            }
-        }
-    }*/
-
-    /// add possible edges
-    for (unsigned int i = 0; i < edges.size(); i++)
-    {
-        if ((edges[i].a.x == e.b.x) & (edges[i].a.y == e.b.y) & (edges[i].a.z == e.b.z))
-            if (!isSame(edges[i],e))
-                if ((edges[i].a.x != edges[i].b.x) | (edges[i].a.z != edges[i].b.z))
-                    output.push_back(i);
-    }
-    return output;
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7FFF;
 }
@@ -94,11 +94,10 @@ float getRotation(float x, float y, float z, float w);
 bool isSame(edge a, edge b);
 
 /**
- * @brief nextEdge gets all possible indexes of next edges
- * @param edges is track curve instance
- * @param e is current edge
- * @return indicies as vector of int
+ * @brief randomInt gets pseudorandom number from local generator
+ * @param seed is state of generator, it is updated
+ * @return number from 0 to 32767
  */
-std::vector<int> nextEdge(std::vector<edge> edges, edge e);
+int randomInt(unsigned int& seed);
 
 #endif // MATH_H
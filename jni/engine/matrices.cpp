@@ -8,8 +8,26 @@
 ///----------------------------------------------------------------------------------------
 
 #define GLM_FORCE_RADIANS
+#include "engine/io.h"
 #include "engine/matrices.h"
+#include "engine/model.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MATRICES_NEON
+#endif
+
+/**
+ * @brief matrices constructor
+ */
+matrices::matrices()
+{
+    matrixDepth = 0;
+    staticRoot = false;
+}
 
 /**
  * @brief lookAt implements GLUlookAt
@@ -20,6 +38,7 @@
 void matrices::lookAt(glm::vec3 eye, glm::vec3 center, glm::vec3 up)
 {
     view_matrix = glm::lookAt(eye, center, up);
+    multiply(glm::value_ptr(proj_matrix), glm::value_ptr(view_matrix), glm::value_ptr(proj_view));
     matrix_result = glm::mat4x4(1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1);
 }
 
@@ -32,11 +51,72 @@ void matrices::lookAt(glm::vec3 eye, glm::vec3 center, glm::vec3 up)
  */
 void matrices::perspective(float fovy, float aspect, float zNear, float zFar)
 {
-    while(!matrixBuffer.empty())
+    matrixDepth = 0;
+    proj_matrix = glm::perspective((float)(fovy * M_PI / 180.0f), aspect, zNear,zFar);
+    multiply(glm::value_ptr(proj_matrix), glm::value_ptr(view_matrix), glm::value_ptr(proj_view));
+}
+
+/**
+ * @brief multiply multiplies column major 4x4 matrices, output may be one of inputs
+ * @param a is left matrix
+ * @param b is right matrix
+ * @param out is result a * b
+ */
+void matrices::multiply(const float* a, const float* b, float* out)
+{
+    multiply(a, b, out, 1);
+}
+
+/**
+ * @brief multiply multiplies array of matrices by one matrix in one pass
+ * @param a is left matrix
+ * @param b is array of right matrices
+ * @param out is array of results a * b[i]
+ * @param count is amount of matrices
+ */
+void matrices::multiply(const float* a, const float* b, float* out, int count)
+{
+    /// columns of left matrix are loaded once, every result column is sum of them
+    /// weighted by column of right matrix which is read before the result is written
+#if defined(__SSE__)
+    __m128 a0 = _mm_loadu_ps(a + 0);
+    __m128 a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+    for (int i = 0; i < count * 4; i++)
     {
-        matrixBuffer.pop();
+        const float* c = b + i * 4;
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(c[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(c[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(c[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(c[3])));
+        _mm_storeu_ps(out + i * 4, r);
     }
-    proj_matrix = glm::perspective((float)(fovy * M_PI / 180.0f), aspect, zNear,zFar);
+#elif defined(MATRICES_NEON)
+    float32x4_t a0 = vld1q_f32(a + 0);
+    float32x4_t a1 = vld1q_f32(a + 4);
+    float32x4_t a2 = vld1q_f32(a + 8);
+    float32x4_t a3 = vld1q_f32(a + 12);
+    for (int i = 0; i < count * 4; i++)
+    {
+        const float* c = b + i * 4;
+        float32x4_t r = vmulq_n_f32(a0, c[0]);
+        r = vmlaq_n_f32(r, a1, c[1]);
+        r = vmlaq_n_f32(r, a2, c[2]);
+        r = vmlaq_n_f32(r, a3, c[3]);
+        vst1q_f32(out + i * 4, r);
+    }
+#else
+    float l[16];
+    for (int j = 0; j < 16; j++)
+        l[j] = a[j];
+    for (int i = 0; i < count * 4; i++)
+    {
+        float c[4] = {b[i * 4 + 0], b[i * 4 + 1], b[i * 4 + 2], b[i * 4 + 3]};
+        for (int j = 0; j < 4; j++)
+            out[i * 4 + j] = l[j] * c[0] + l[4 + j] * c[1] + l[8 + j] * c[2] + l[12 + j] * c[3];
+    }
+#endif
 }
 
 /**
@@ -45,12 +125,7 @@ void matrices::perspective(float fovy, float aspect, float zNear, float zFar)
  */
 void matrices::multMatrix(float* matrix)
 {
-  matrix_result *= glm::mat4x4(
-      matrix[0], matrix[1], matrix[2], matrix[3],
-      matrix[4], matrix[5], matrix[6], matrix[7],
-      matrix[8], matrix[9], matrix[10], matrix[11],
-      matrix[12], matrix[13], matrix[14], matrix[15]
-  );
+  multiply(glm::value_ptr(matrix_result), matrix, glm::value_ptr(matrix_result));
 }
 
 /**
@@ -59,8 +134,13 @@ void matrices::multMatrix(float* matrix)
 void matrices::popMatrix()
 {
   /// popping matrix from stack
-  matrix_result = (glm::mat4x4)matrixBuffer.top();
-  matrixBuffer.pop();
+  if (matrixDepth <= 0)
+  {
+    loge("Matrix stack underflow", "");
+    return;
+  }
+  matrixDepth--;
+  matrix_result = matrixBuffer[matrixDepth];
 }
 
 /**
@@ -68,8 +148,14 @@ void matrices::popMatrix()
  */
 void matrices::pushMatrix()
 {
-  /// push matrix m to stack
-  matrixBuffer.push(matrix_result);
+  /// push matrix m to stack, matrix over capacity is not stored
+  if (matrixDepth >= MATRIX_STACK_SIZE)
+  {
+    loge("Matrix stack overflow", "");
+    return;
+  }
+  matrixBuffer[matrixDepth] = matrix_result;
+  matrixDepth++;
 }
 
 /**
@@ -79,15 +165,12 @@ void matrices::pushMatrix()
 void matrices::rotateX(float value)
 {
   float radian = value * M_PI / 180;
-  /// rotation matrix for 2D transformations (around Z axis)
-  glm::mat4x4 rotation(
-      1,0,0,0,
-      0,cosf(radian),-sinf(radian),0,
-      0,sinf(radian),cosf(radian),0,
-      0,0,0,1
-  );
-  /// mult current maxtrix
-  matrix_result *= rotation;
+  float c = cosf(radian);
+  float sn = sinf(radian);
+  /// only columns of Y and Z axis change
+  glm::vec4 y = matrix_result[1];
+  matrix_result[1] = y * c - matrix_result[2] * sn;
+  matrix_result[2] = y * sn + matrix_result[2] * c;
 }
 
 /**
@@ -97,15 +180,12 @@ void matrices::rotateX(float value)
 void matrices::rotateY(float value)
 {
   float radian = value * M_PI / 180;
-  /// rotation matrix for 2D transformations (around Z axis)
-  glm::mat4x4 rotation(
-      cosf(radian),0,-sinf(radian),0,
-      0,1,0,0,
-      sinf(radian),0,cosf(radian),0,
-      0,0,0,1
-  );
-  /// mult current maxtrix
-  matrix_result *= rotation;
+  float c = cosf(radian);
+  float sn = sinf(radian);
+  /// only columns of X and Z axis change
+  glm::vec4 x = matrix_result[0];
+  matrix_result[0] = x * c - matrix_result[2] * sn;
+  matrix_result[2] = x * sn + matrix_result[2] * c;
 }
 
 /**
@@ -115,15 +195,12 @@ void matrices::rotateY(float value)
 void matrices::rotateZ(float value)
 {
   float radian = value * M_PI / 180;
-  /// rotation matrix for 2D transformations (around Z axis)
-  glm::mat4x4 rotation(
-      cosf(radian),sinf(radian),0,0,
-      -sinf(radian),cosf(radian),0,0,
-      0,0,1,0,
-      0,0,0,1
-  );
-  /// mult current maxtrix
-  matrix_result *= rotation;
+  float c = cosf(radian);
+  float sn = sinf(radian);
+  /// only columns of X and Y axis change
+  glm::vec4 x = matrix_result[0];
+  matrix_result[0] = x * c + matrix_result[1] * sn;
+  matrix_result[1] = matrix_result[1] * c - x * sn;
 }
 
 /**
@@ -132,15 +209,58 @@ void matrices::rotateZ(float value)
  */
 void matrices::scale(float value)
 {
-  /// scale matrix
-  glm::mat4x4 scale(
-      value,0,0,0,
-      0,value,0,0,
-      0,0,value,0,
-      0,0,0,1
-  );
-  /// mult current maxtrix
-  matrix_result *= scale;
+  /// scale columns of axes
+  matrix_result[0] *= value;
+  matrix_result[1] *= value;
+  matrix_result[2] *= value;
+}
+
+/**
+ * @brief setMatrices sets projection, view and current model matrix
+ * @param proj is projection matrix
+ * @param view is view matrix
+ * @param model is current model matrix
+ */
+void matrices::setMatrices(glm::mat4x4 proj, glm::mat4x4 view, glm::mat4x4 model)
+{
+  proj_matrix = proj;
+  view_matrix = view;
+  matrix_result = model;
+  multiply(glm::value_ptr(proj_matrix), glm::value_ptr(view_matrix), glm::value_ptr(proj_view));
+}
+
+/**
+ * @brief subModelMatrix counts model, model view and rendering matrix of model part
+ * @param m is model part
+ */
+void matrices::subModelMatrix(model3d* m)
+{
+  /// static part in scene root is only translated into its region, view dependent
+  /// products differ from per frame matrices only by position column
+  if (!m->dynamic && staticRoot)
+  {
+    glm::vec4 position = glm::vec4(m->reg.min, 1);
+    modelMat = glm::mat4x4(1);
+    modelMat[3] = position;
+    modelView = view_matrix;
+    modelView[3] = view_matrix * position;
+    matrix = proj_view;
+    matrix[3] = proj_view * position;
+    return;
+  }
+
+  /// translation is added into position column without full multiplication
+  glm::vec3 offset = m->reg.min;
+  if (m->dynamic)
+  {
+    modelMat = glm::make_mat4(m->dynamicMat);
+    offset = (m->reg.min - m->reg.max) * 0.5f;
+  }
+  else
+    modelMat = matrix_result;
+  modelMat[3] += modelMat[0] * offset.x + modelMat[1] * offset.y + modelMat[2] * offset.z;
+  multiply(glm::value_ptr(view_matrix), glm::value_ptr(modelMat), glm::value_ptr(modelView));
+  multiply(glm::value_ptr(proj_view), glm::value_ptr(modelMat), glm::value_ptr(matrix));
 }
 
 /**
@@ -151,13 +271,6 @@ void matrices::scale(float value)
  */
 void matrices::translate(float x, float y, float z)
 {
-  /// transformation matrix
-  glm::mat4x4 translation(
-      1,0,0,0,
-      0,1,0,0,
-      0,0,1,0,
-      x,y,z,1
-  );
-  /// mult current matrix
-  matrix_result *= translation;
+  /// only column of position changes
+  matrix_result[3] += matrix_result[0] * x + matrix_result[1] * y + matrix_result[2] * z;
 }
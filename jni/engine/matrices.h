@@ -11,14 +11,25 @@
 #define MATRICES_H
 
 #include <glm/glm.hpp>
-#include <stack>
+
+#define MATRIX_STACK_SIZE 32
+
+struct model3d;
 
 /**
- * @brief The input interface
+ * @brief The matrices class
  */
 class matrices
 {
 public:
+
+    bool staticRoot;     ///< True while static parts are rendered in scene root
+
+    /**
+     * @brief matrices constructor
+     */
+    matrices();
+
     /**
      * @brief lookAt implements GLUlookAt
      * @param eye is eye vector
@@ -36,6 +47,23 @@ public:
      */
     void perspective(float fovy, float aspect, float zNear, float zFar);
 
+    /**
+     * @brief multiply multiplies column major 4x4 matrices, output may be one of inputs
+     * @param a is left matrix
+     * @param b is right matrix
+     * @param out is result a * b
+     */
+    static void multiply(const float* a, const float* b, float* out);
+
+    /**
+     * @brief multiply multiplies array of matrices by one matrix in one pass
+     * @param a is left matrix
+     * @param b is array of right matrices
+     * @param out is array of results a * b[i]
+     * @param count is amount of matrices
+     */
+    static void multiply(const float* a, const float* b, float* out, int count);
+
     /**
      * @brief multMatrix multiplies with matrix
      * @param matrix is 4x4 matrix in OpenGL format
@@ -76,6 +104,14 @@ public:
      */
     void scale(float value);
 
+    /**
+     * @brief setMatrices sets projection, view and current model matrix
+     * @param proj is projection matrix
+     * @param view is view matrix
+     * @param model is current model matrix
+     */
+    void setMatrices(glm::mat4x4 proj, glm::mat4x4 view, glm::mat4x4 model);
+
     /**
      * @brief translate translates object
      * @param x is translate coordinate
@@ -85,12 +121,22 @@ public:
     void translate(float x, float y, float z);
 
 protected:
-    glm::mat4x4 matrix;                   ///< Matrix for dynamic rendering
-    glm::mat4x4 modelMat;                 ///< Model matrix
-    glm::mat4x4 matrix_result;            ///< Temp matrix for calculations
-    glm::mat4x4 proj_matrix;              ///< Scene projection matrix
-    glm::mat4x4 view_matrix;              ///< View matrix
-    std::stack<glm::mat4x4> matrixBuffer; ///< Matrix stack
+
+    /**
+     * @brief subModelMatrix counts model, model view and rendering matrix of model part
+     * @param m is model part
+     */
+    void subModelMatrix(model3d* m);
+
+    glm::mat4x4 matrix;                                   ///< Matrix for dynamic rendering
+    glm::mat4x4 modelMat;                                 ///< Model matrix
+    glm::mat4x4 modelView;                                ///< Model view matrix
+    glm::mat4x4 matrix_result;                            ///< Temp matrix for calculations
+    glm::mat4x4 proj_matrix;                              ///< Scene projection matrix
+    glm::mat4x4 proj_view;                                ///< Projection multiplied by view
+    glm::mat4x4 view_matrix;                              ///< View matrix
+    glm::mat4x4 matrixBuffer[MATRIX_STACK_SIZE];          ///< Matrix stack
+    int matrixDepth;                                      ///< Amount of matrices in stack
 };
 
 #endif // MATRICES_H
@@ -9,6 +9,7 @@
 
 #include "engine/io.h"
 #include "engine/model.h"
+#include "engine/profiler.h"
 
 //http://stackoverflow.com/questions/23880160/stdmap-key-no-match-for-operator
 bool operator<(const id3d& lhs, const id3d& rhs)
@@ -17,6 +18,17 @@ bool operator<(const id3d& lhs, const id3d& rhs)
            lhs.x == rhs.x && (lhs.y < rhs.y || lhs.y == rhs.y && lhs.z < rhs.z);
 }
 
+/**
+ * @brief materialShader gets shader name from material parameters
+ * @param material is material parameters after '%' character
+ * @return shader name
+ */
+std::string materialShader(const char* material)
+{
+    std::string name = material;
+    return name.substr(0, name.find('/'));
+}
+
 /**
  * @brief model destructor
  */
@@ -42,6 +54,7 @@ model::~model()
  */
 model::model(std::string filename, materialLoader* mtlLoader)
 {
+    PROFILE("model::model");
     /// open file
     file* f = getFile(filename);
 
@@ -110,20 +123,8 @@ model::model(std::string filename, materialLoader* mtlLoader)
             {
                 cursor++;
                 m.texture2D->transparent = false;
-                char* shadername = new char[strlen(material) - cursor + 1];
-                for (unsigned int j = cursor; j < strlen(material); j++)
-                {
-                    shadername[j - cursor] = material[j];
-                    if (material[j] == '/')
-                    {
-                        shadername[j - cursor] = '\000';
-                        break;
-                    }
-                }
-                shadername[strlen(material) - cursor] = '\000';
                 m.material->instanceCount--;
-                m.material = mtlLoader->getShader(shadername);
-                delete[] shadername;
+                m.material = mtlLoader->getShader(materialShader(material + cursor));
                 break;
             } else
                 break;
@@ -154,3 +155,41 @@ model::model(std::string filename, materialLoader* mtlLoader)
     }
     delete f;
 }
+
+/**
+ * @brief getShaders gets names of shaders used by model without loading it
+ * @param filename is path and name of model file
+ * @return list of shader names
+ */
+std::vector<std::string> model::getShaders(std::string filename)
+{
+    std::vector<std::string> output;
+    file* f = getFile(filename);
+    char line[1024];
+    f->gets(line);
+    int textureCount = f->scandec();
+
+    /// default shader depends on texture, every part compiles it before its material
+    if (textureCount > 0)
+    {
+        output.push_back("standart");
+        output.push_back("standart_alpha");
+    }
+
+    /// only material is parsed, triangles are skipped
+    for (int i = 0; i < textureCount; i++)
+    {
+        char material[255];
+        material[0] = '\0';
+        f->gets(line);
+        sscanf(line, "%*f %*f %*f %*f %*f %*f %*s %*f %*f %*f %*f %*f %*f %*f %*f %*f %*f %s", &material[0]);
+        const char* shader = strchr(material, '%');
+        if (shader)
+            output.push_back(materialShader(shader + 1));
+        int count = f->scandec();
+        for (int j = 0; j < count; j++)
+            f->gets(line);
+    }
+    delete f;
+    return output;
+}
@@ -43,7 +43,6 @@ struct model3d
     int filter;                  ///< filter index
     shader* material;            ///< shader to use
     bool dynamic;                ///< True if object is dynamic
-    int dynamicID;               ///< ID of the dynamic object
     float dynamicMat[16];        ///< Model matrix of dynamic object
     AABB reg;                    ///< AABB of the object
     int count;                   ///< Amount of triangles
@@ -71,6 +70,13 @@ public:
      */
     model(std::string filename, materialLoader* mtlLoader);
 
+    /**
+     * @brief getShaders gets names of shaders used by model without loading it
+     * @param filename is path and name of model file
+     * @return list of shader names
+     */
+    static std::vector<std::string> getShaders(std::string filename);
+
     std::vector<model3d> models;               ///< Standard parts of model
     AABB aabb;                                 ///< Extremes of current model
     bool toDelete;                             ///< Additional information for culling
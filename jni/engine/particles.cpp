@@ -0,0 +1,86 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       particles.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Particle system which keeps every particle attribute in its own array, the
+ *             particles are ordered by age so particles of the same age are drawn together.
+**/
+///----------------------------------------------------------------------------------------
+
+#include "engine/math.h"
+#include "engine/particles.h"
+
+/**
+ * @brief particles constructor
+ * @param lifetime is amount of ticks of particle life
+ */
+particles::particles(int lifetime)
+{
+    this->lifetime = lifetime;
+    seed = 1;
+}
+
+/**
+ * @brief emit adds new particle, it is the youngest one
+ * @param x is x coordinate
+ * @param y is y coordinate
+ * @param z is z coordinate
+ */
+void particles::emit(float x, float y, float z)
+{
+    this->x.push_back(x);
+    this->y.push_back(y);
+    this->z.push_back(z);
+    age.push_back(0);
+}
+
+/**
+ * @brief getGroup gets end of particles with the same age
+ * @param first is index of first particle of group
+ * @return index after last particle of group
+ */
+int particles::getGroup(int first)
+{
+    int count = getCount();
+    int last = first + 1;
+    while ((last < count) && (age[last] == age[first]))
+        last++;
+    return last;
+}
+
+/**
+ * @brief random gets pseudorandom number from generator of particle system
+ * @return number from -1 to 1
+ */
+float particles::random()
+{
+    return randomInt(seed) / 16383.5f - 1.0f;
+}
+
+/**
+ * @brief update makes particles older and removes expired particles
+ */
+void particles::update()
+{
+    int count = getCount();
+    if (count == 0)
+        return;
+
+    /// loop without branches over plain array is vectorized by compiler
+    int* ages = &age[0];
+    for (int i = 0; i < count; i++)
+        ages[i]++;
+
+    /// the oldest particles are at the beginning, they are removed at once
+    int expired = 0;
+    while ((expired < count) && (ages[expired] >= lifetime))
+        expired++;
+    if (expired > 0)
+    {
+        x.erase(x.begin(), x.begin() + expired);
+        y.erase(y.begin(), y.begin() + expired);
+        z.erase(z.begin(), z.begin() + expired);
+        age.erase(age.begin(), age.begin() + expired);
+    }
+}
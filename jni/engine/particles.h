@@ -0,0 +1,70 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       particles.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Particle system which keeps every particle attribute in its own array, the
+ *             particles are ordered by age so particles of the same age are drawn together.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <vector>
+
+/**
+ * @brief The particles class
+ */
+class particles
+{
+public:
+    std::vector<float> x;   ///< X coordinates of particles
+    std::vector<float> y;   ///< Y coordinates of particles
+    std::vector<float> z;   ///< Z coordinates of particles
+    std::vector<int> age;   ///< Ages of particles in ticks, the oldest particle is first
+
+    /**
+     * @brief particles constructor
+     * @param lifetime is amount of ticks of particle life
+     */
+    particles(int lifetime);
+
+    /**
+     * @brief emit adds new particle, it is the youngest one
+     * @param x is x coordinate
+     * @param y is y coordinate
+     * @param z is z coordinate
+     */
+    void emit(float x, float y, float z);
+
+    /**
+     * @brief getCount gets amount of living particles
+     * @return amount of particles
+     */
+    int getCount() { return (int)age.size(); }
+
+    /**
+     * @brief getGroup gets end of particles with the same age
+     * @param first is index of first particle of group
+     * @return index after last particle of group
+     */
+    int getGroup(int first);
+
+    /**
+     * @brief random gets pseudorandom number from generator of particle system
+     * @return number from -1 to 1
+     */
+    float random();
+
+    /**
+     * @brief update makes particles older and removes expired particles
+     */
+    void update();
+
+private:
+    int lifetime;           ///< Amount of ticks of particle life
+    unsigned int seed;      ///< State of random generator
+};
+
+#endif // PARTICLES_H
@@ -0,0 +1,280 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       profiler.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Scoped timers of hot code, every thread records into its own ring buffer
+ *             without locking. Profiling can be compiled out by defining NO_PROFILER.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "engine/io.h"
+#include "engine/profiler.h"
+
+#define PROFILER_GPU_THREAD -1
+#define PROFILER_RING_SIZE 4096
+
+/**
+ * @brief profileEvent is one measured scope
+ */
+struct profileEvent
+{
+    const char* name;   ///< Name of scope
+    double start;       ///< Start time in milliseconds
+    double end;         ///< End time in milliseconds
+    int thread;         ///< Index of thread
+};
+
+/**
+ * @brief profileRing is ring buffer of events written only by owning thread
+ */
+struct profileRing
+{
+    profileEvent events[PROFILER_RING_SIZE];    ///< Recorded events
+    volatile unsigned int head;                 ///< Amount of written events
+    unsigned int read;                          ///< Amount of events summed into frames
+    int thread;                                 ///< Index of owning thread
+    bool used;                                  ///< Ring is owned by running thread
+};
+
+static std::vector<profileRing*> rings;                         ///< Rings of all threads
+static std::vector<profileSection> sections;                    ///< Sections of last frame
+static profileRing* gpuRing = 0;                                ///< Ring of GPU passes
+static int threadCount = 0;                                     ///< Amount of registered threads
+static pthread_key_t ringKey;                                   ///< Ring of current thread
+static pthread_once_t ringOnce = PTHREAD_ONCE_INIT;             ///< Creation of ring key
+static pthread_mutex_t ringMutex = PTHREAD_MUTEX_INITIALIZER;   ///< Lock for list of rings
+
+/**
+ * @brief releaseRing makes ring of finished thread available for another thread
+ * @param ptr is ring instance
+ */
+static void releaseRing(void* ptr)
+{
+    pthread_mutex_lock(&ringMutex);
+    ((profileRing*)ptr)->used = false;
+    pthread_mutex_unlock(&ringMutex);
+}
+
+/**
+ * @brief createRingKey creates thread specific key for rings
+ */
+static void createRingKey()
+{
+    pthread_key_create(&ringKey, releaseRing);
+}
+
+/**
+ * @brief getRing gets ring buffer of current thread
+ * @return ring instance
+ */
+static profileRing* getRing()
+{
+    pthread_once(&ringOnce, createRingKey);
+    profileRing* ring = (profileRing*)pthread_getspecific(ringKey);
+    if (ring)
+        return ring;
+
+    /// reuse ring of finished thread, loading threads are started often
+    pthread_mutex_lock(&ringMutex);
+    for (unsigned int i = 0; i < rings.size(); i++)
+        if (!rings[i]->used)
+        {
+            ring = rings[i];
+            break;
+        }
+    if (!ring)
+    {
+        ring = new profileRing();
+        ring->head = 0;
+        ring->read = 0;
+        rings.push_back(ring);
+    }
+    ring->used = true;
+    ring->thread = threadCount++;
+    pthread_mutex_unlock(&ringMutex);
+    pthread_setspecific(ringKey, ring);
+    return ring;
+}
+
+/**
+ * @brief write adds finished event into ring buffer
+ * @param ring is ring buffer written only by calling thread
+ * @param name is name of event, it must be string literal
+ * @param start is start time in milliseconds
+ * @param end is end time in milliseconds
+ */
+static void write(profileRing* ring, const char* name, double start, double end)
+{
+    profileEvent& e = ring->events[ring->head % PROFILER_RING_SIZE];
+    e.name = name;
+    e.start = start;
+    e.end = end;
+    e.thread = ring->thread;
+
+    /// event must be complete before readers see it
+    __sync_synchronize();
+    ring->head = ring->head + 1;
+}
+
+/**
+ * @brief profiler starts measuring of scope
+ * @param name is name of scope, it must be string literal
+ */
+profiler::profiler(const char* name)
+{
+    this->name = name;
+    start = getTime();
+}
+
+/**
+ * @brief profiler destructor finishes measuring of scope
+ */
+profiler::~profiler()
+{
+    record(name, start, getTime());
+}
+
+/**
+ * @brief exportTrace writes all recorded events in Chrome trace event format
+ * @param filename is path of JSON file
+ * @return true if file was written
+ */
+bool profiler::exportTrace(std::string filename)
+{
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file)
+        return false;
+
+    /// events are written as complete events with time in microseconds
+    bool first = true;
+    fprintf(file, "{\"traceEvents\":[\n");
+    pthread_mutex_lock(&ringMutex);
+    if (gpuRing)
+    {
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"GPU\"}}",
+                PROFILER_GPU_THREAD);
+        first = false;
+    }
+    for (unsigned int i = 0; i < rings.size(); i++)
+    {
+        unsigned int head = rings[i]->head;
+        unsigned int count = head < PROFILER_RING_SIZE ? head : PROFILER_RING_SIZE;
+        for (unsigned int j = head - count; j < head; j++)
+        {
+            profileEvent& e = rings[i]->events[j % PROFILER_RING_SIZE];
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",\n", e.name, e.thread, e.start * 1000.0, (e.end - e.start) * 1000.0);
+            first = false;
+        }
+    }
+    pthread_mutex_unlock(&ringMutex);
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief frame finishes frame and counts time of sections in it
+ */
+void profiler::frame()
+{
+    pthread_mutex_lock(&ringMutex);
+    sections.clear();
+    for (unsigned int i = 0; i < rings.size(); i++)
+    {
+        /// events written since last frame, GPU passes arrive a few frames later
+        unsigned int head = rings[i]->head;
+        unsigned int first = rings[i]->read;
+        if (head - first > PROFILER_RING_SIZE)
+            first = head - PROFILER_RING_SIZE;
+        rings[i]->read = head;
+        for (unsigned int j = first; j < head; j++)
+        {
+            profileEvent& e = rings[i]->events[j % PROFILER_RING_SIZE];
+
+            /// names are literals, the same pointer is the same section mostly
+            unsigned int k = 0;
+            while ((k < sections.size()) && (sections[k].name != e.name) && strcmp(sections[k].name, e.name))
+                k++;
+            if (k == sections.size())
+            {
+                profileSection s;
+                s.name = e.name;
+                s.time = 0;
+                s.count = 0;
+                sections.push_back(s);
+            }
+            sections[k].time += e.end - e.start;
+            sections[k].count++;
+        }
+    }
+    pthread_mutex_unlock(&ringMutex);
+}
+
+/**
+ * @brief getSectionCount gets amount of sections of last frame
+ * @return amount of sections
+ */
+int profiler::getSectionCount()
+{
+    pthread_mutex_lock(&ringMutex);
+    int count = sections.size();
+    pthread_mutex_unlock(&ringMutex);
+    return count;
+}
+
+/**
+ * @brief getSection gets section of last frame
+ * @param index is index of section
+ * @return section with name and time
+ */
+profileSection profiler::getSection(int index)
+{
+    profileSection s;
+    s.name = "";
+    s.time = 0;
+    s.count = 0;
+    pthread_mutex_lock(&ringMutex);
+    if ((index >= 0) && (index < (int)sections.size()))
+        s = sections[index];
+    pthread_mutex_unlock(&ringMutex);
+    return s;
+}
+
+/**
+ * @brief record adds finished event into ring buffer of current thread
+ * @param name is name of event, it must be string literal
+ * @param start is start time in milliseconds
+ * @param end is end time in milliseconds
+ */
+void profiler::record(const char* name, double start, double end)
+{
+    write(getRing(), name, start, end);
+}
+
+/**
+ * @brief recordGPU adds measured GPU pass, passes are shown as separate thread
+ * @param name is name of pass, it must be string literal
+ * @param start is start time in milliseconds
+ * @param end is end time in milliseconds
+ */
+void profiler::recordGPU(const char* name, double start, double end)
+{
+    /// ring is never released, it is written only by rendering thread
+    if (!gpuRing)
+    {
+        pthread_mutex_lock(&ringMutex);
+        gpuRing = new profileRing();
+        gpuRing->head = 0;
+        gpuRing->read = 0;
+        gpuRing->thread = PROFILER_GPU_THREAD;
+        gpuRing->used = true;
+        rings.push_back(gpuRing);
+        pthread_mutex_unlock(&ringMutex);
+    }
+    write(gpuRing, name, start, end);
+}
@@ -0,0 +1,97 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       profiler.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Scoped timers of hot code, every thread records into its own ring buffer
+ *             without locking. Profiling can be compiled out by defining NO_PROFILER.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <vector>
+
+#ifdef NO_PROFILER
+#define PROFILE(name)
+#else
+#define PROFILE(name) profiler profilerScope(name)
+#endif
+
+/**
+ * @brief profileSection is time of one named part of frame
+ */
+struct profileSection
+{
+    const char* name;   ///< Name of section
+    double time;        ///< Time spent in milliseconds
+    int count;          ///< Amount of calls
+};
+
+/**
+ * @brief The profiler class
+ */
+class profiler
+{
+public:
+
+    /**
+     * @brief profiler starts measuring of scope
+     * @param name is name of scope, it must be string literal
+     */
+    profiler(const char* name);
+
+    /**
+     * @brief profiler destructor finishes measuring of scope
+     */
+    ~profiler();
+
+    /**
+     * @brief exportTrace writes all recorded events in Chrome trace event format
+     * @param filename is path of JSON file
+     * @return true if file was written
+     */
+    static bool exportTrace(std::string filename);
+
+    /**
+     * @brief frame finishes frame and counts time of sections in it
+     */
+    static void frame();
+
+    /**
+     * @brief getSectionCount gets amount of sections of last frame
+     * @return amount of sections
+     */
+    static int getSectionCount();
+
+    /**
+     * @brief getSection gets section of last frame
+     * @param index is index of section
+     * @return section with name and time
+     */
+    static profileSection getSection(int index);
+
+    /**
+     * @brief record adds finished event into ring buffer of current thread
+     * @param name is name of event, it must be string literal
+     * @param start is start time in milliseconds
+     * @param end is end time in milliseconds
+     */
+    static void record(const char* name, double start, double end);
+
+    /**
+     * @brief recordGPU adds measured GPU pass, passes are shown as separate thread
+     * @param name is name of pass, it must be string literal
+     * @param start is start time in milliseconds
+     * @param end is end time in milliseconds
+     */
+    static void recordGPU(const char* name, double start, double end);
+
+private:
+    const char* name;   ///< Name of scope
+    double start;       ///< Start time of scope
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,159 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       renderstate.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Sequences of render state changes shared by all renderers, GL renderer
+ *             applies them and null renderer counts them.
+**/
+///----------------------------------------------------------------------------------------
+
+#include "engine/renderstate.h"
+
+/**
+ * @brief beginBlob sets state for blob shadows
+ */
+void renderstate::beginBlob()
+{
+    /// blobs darken scene without stencil, depth test hides them behind objects
+    applyState(STATE_DEPTH_MASK, false);
+    applyState(STATE_BLEND, true);
+    applyState(STATE_CULL_FACE, false);
+    applyState(STATE_BLEND_FUNC, STATE_BLEND_ONE);
+    applyState(STATE_BLEND_SUBTRACT, true);
+}
+
+/**
+ * @brief beginComposite sets state for rendering of FBO on screen
+ */
+void renderstate::beginComposite()
+{
+    applyState(STATE_FRAMEBUFFER, false);
+    applyState(STATE_VIEWPORT, false);
+    applyState(STATE_BLEND, false);
+    applyState(STATE_DEPTH_TEST, false);
+    applyState(STATE_DEPTH_MASK, false);
+}
+
+/**
+ * @brief beginEffects sets state for additive effects
+ */
+void renderstate::beginEffects()
+{
+    applyState(STATE_BLEND, true);
+    applyState(STATE_DEPTH_TEST, false);
+    applyState(STATE_BLEND_FUNC, STATE_BLEND_ALPHA);
+    applyState(STATE_CULL_FACE, false);
+}
+
+/**
+ * @brief beginFrame sets state for rendering of scene into FBO
+ */
+void renderstate::beginFrame()
+{
+    applyState(STATE_FRAMEBUFFER, true);
+    applyState(STATE_VIEWPORT, true);
+    applyState(STATE_CLEAR, true);
+    applyState(STATE_DEPTH_TEST, true);
+    applyState(STATE_DEPTH_MASK, true);
+}
+
+/**
+ * @brief beginModel sets state for model
+ */
+void renderstate::beginModel()
+{
+    applyState(STATE_CULL_FACE, false);
+}
+
+/**
+ * @brief beginShadow sets state for shadow volumes
+ */
+void renderstate::beginShadow()
+{
+    applyState(STATE_DEPTH_MASK, false);
+    applyState(STATE_BLEND, true);
+    applyState(STATE_STENCIL_TEST, true);
+    applyState(STATE_BLEND_FUNC, STATE_BLEND_ONE);
+    applyState(STATE_BLEND_SUBTRACT, true);
+    applyState(STATE_STENCIL_MASK, true);
+}
+
+/**
+ * @brief beginSubModel binds previous screen for model part
+ */
+void renderstate::beginSubModel()
+{
+    applyState(STATE_SCREEN_TEXTURE, true);
+}
+
+/**
+ * @brief endBlob restores state after blob shadows
+ */
+void renderstate::endBlob()
+{
+    applyState(STATE_BLEND_SUBTRACT, false);
+    applyState(STATE_BLEND, false);
+    applyState(STATE_DEPTH_MASK, true);
+}
+
+/**
+ * @brief endComposite restores state after rendering of FBO on screen
+ */
+void renderstate::endComposite()
+{
+    applyState(STATE_ARRAY_BUFFER, false);
+    applyState(STATE_DEPTH_MASK, true);
+}
+
+/**
+ * @brief endEffects restores state after additive effects
+ */
+void renderstate::endEffects()
+{
+    applyState(STATE_ARRAY_BUFFER, false);
+    applyState(STATE_BLEND, false);
+    applyState(STATE_DEPTH_TEST, true);
+}
+
+/**
+ * @brief endShadow restores state after shadow volumes
+ */
+void renderstate::endShadow()
+{
+    applyState(STATE_BLEND_SUBTRACT, false);
+    applyState(STATE_DEPTH_GREATER, false);
+    applyState(STATE_DEPTH_MASK, true);
+    applyState(STATE_STENCIL_TEST, false);
+    applyState(STATE_STENCIL_MASK, false);
+}
+
+/**
+ * @brief endSubModel releases vertex data of model part
+ */
+void renderstate::endSubModel()
+{
+    applyState(STATE_ARRAY_BUFFER, false);
+}
+
+/**
+ * @brief shadowPaint sets state for painting shadow where stencil was marked
+ */
+void renderstate::shadowPaint()
+{
+    applyState(STATE_COLOR_MASK, true);
+    applyState(STATE_DEPTH_GREATER, true);
+    applyState(STATE_STENCIL_EQUAL, true);
+    applyState(STATE_STENCIL_INCREMENT, true);
+}
+
+/**
+ * @brief shadowVolume sets state for marking shadow volume into stencil
+ */
+void renderstate::shadowVolume()
+{
+    applyState(STATE_COLOR_MASK, false);
+    applyState(STATE_DEPTH_GREATER, false);
+    applyState(STATE_STENCIL_EQUAL, false);
+    applyState(STATE_STENCIL_INCREMENT, false);
+}
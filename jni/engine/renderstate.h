@@ -0,0 +1,126 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       renderstate.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Sequences of render state changes shared by all renderers, GL renderer
+ *             applies them and null renderer counts them.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef RENDERSTATE_H
+#define RENDERSTATE_H
+
+#define STATE_ARRAY_BUFFER 0
+#define STATE_BLEND 1
+#define STATE_BLEND_ALPHA 1
+#define STATE_BLEND_FUNC 2
+#define STATE_BLEND_ONE 0
+#define STATE_BLEND_SUBTRACT 3
+#define STATE_CLEAR 4
+#define STATE_COLOR_MASK 5
+#define STATE_CULL_FACE 6
+#define STATE_DEPTH_GREATER 7
+#define STATE_DEPTH_MASK 8
+#define STATE_DEPTH_TEST 9
+#define STATE_FRAMEBUFFER 10
+#define STATE_SCREEN_TEXTURE 11
+#define STATE_STENCIL_EQUAL 12
+#define STATE_STENCIL_INCREMENT 13
+#define STATE_STENCIL_MASK 14
+#define STATE_STENCIL_TEST 15
+#define STATE_VIEWPORT 16
+
+/**
+ * @brief The render state class
+ */
+class renderstate
+{
+public:
+
+    /**
+     * @brief renderstate destructor
+     */
+    virtual ~renderstate() {}
+
+protected:
+
+    /**
+     * @brief applyState applies one change of render state
+     * @param type is one of STATE_ defines
+     * @param value is new value of state
+     */
+    virtual void applyState(int type, int value) = 0;
+
+    /**
+     * @brief beginBlob sets state for blob shadows
+     */
+    void beginBlob();
+
+    /**
+     * @brief beginComposite sets state for rendering of FBO on screen
+     */
+    void beginComposite();
+
+    /**
+     * @brief beginEffects sets state for additive effects
+     */
+    void beginEffects();
+
+    /**
+     * @brief beginFrame sets state for rendering of scene into FBO
+     */
+    void beginFrame();
+
+    /**
+     * @brief beginModel sets state for model
+     */
+    void beginModel();
+
+    /**
+     * @brief beginShadow sets state for shadow volumes
+     */
+    void beginShadow();
+
+    /**
+     * @brief beginSubModel binds previous screen for model part
+     */
+    void beginSubModel();
+
+    /**
+     * @brief endBlob restores state after blob shadows
+     */
+    void endBlob();
+
+    /**
+     * @brief endComposite restores state after rendering of FBO on screen
+     */
+    void endComposite();
+
+    /**
+     * @brief endEffects restores state after additive effects
+     */
+    void endEffects();
+
+    /**
+     * @brief endShadow restores state after shadow volumes
+     */
+    void endShadow();
+
+    /**
+     * @brief endSubModel releases vertex data of model part
+     */
+    void endSubModel();
+
+    /**
+     * @brief shadowPaint sets state for painting shadow where stencil was marked
+     */
+    void shadowPaint();
+
+    /**
+     * @brief shadowVolume sets state for marking shadow volume into stencil
+     */
+    void shadowVolume();
+};
+
+#endif // RENDERSTATE_H
@@ -0,0 +1,84 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       resolution.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Dynamic resolution controller which changes render scale slowly to keep
+ *             measured frame time near the target.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <glm/glm.hpp>
+#include <math.h>
+#include "engine/resolution.h"
+
+#define RESOLUTION_FRAMES 10
+#define RESOLUTION_HIGH 1.0
+#define RESOLUTION_LOW 0.8
+#define RESOLUTION_STEP 0.05
+
+/**
+ * @brief resolution constructor, controller is disabled by default
+ */
+resolution::resolution()
+{
+    target = 0;
+    minScale = 1;
+    maxScale = 1;
+    sum = 0;
+    count = 0;
+}
+
+/**
+ * @brief setMaxScale sets the highest allowed scale
+ * @param maxScale is scale chosen by user
+ */
+void resolution::setMaxScale(float maxScale)
+{
+    this->maxScale = maxScale;
+    sum = 0;
+    count = 0;
+}
+
+/**
+ * @brief setTarget sets wanted frame time
+ * @param frameTime is wanted frame time in milliseconds, 0 disables controller
+ * @param minScale is the lowest allowed scale
+ */
+void resolution::setTarget(float frameTime, float minScale)
+{
+    target = frameTime;
+    this->minScale = minScale;
+    sum = 0;
+    count = 0;
+}
+
+/**
+ * @brief update counts new scale from measured frame
+ * @param frameTime is measured frame time in milliseconds
+ * @param scale is current scale
+ * @return scale to use
+ */
+float resolution::update(float frameTime, float scale)
+{
+    if (!isEnabled())
+        return scale;
+
+    /// decide only from average of several frames
+    sum += frameTime;
+    count++;
+    if (count < RESOLUTION_FRAMES)
+        return scale;
+    float average = sum / count;
+    sum = 0;
+    count = 0;
+
+    /// frame time between low and high limit is fine, it avoids oscillating
+    if ((average <= target * RESOLUTION_HIGH) && (average >= target * RESOLUTION_LOW))
+        return scale;
+
+    /// frame time depends on amount of pixels, change is limited to be invisible
+    float wanted = scale * sqrtf(target * (RESOLUTION_HIGH + RESOLUTION_LOW) * 0.5f / average);
+    wanted = glm::clamp(wanted, scale - (float)RESOLUTION_STEP, scale + (float)RESOLUTION_STEP);
+    return glm::clamp(wanted, glm::min(minScale, maxScale), maxScale);
+}
@@ -0,0 +1,61 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       resolution.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Dynamic resolution controller which changes render scale slowly to keep
+ *             measured frame time near the target.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef RESOLUTION_H
+#define RESOLUTION_H
+
+/**
+ * @brief The dynamic resolution class
+ */
+class resolution
+{
+public:
+
+    /**
+     * @brief resolution constructor, controller is disabled by default
+     */
+    resolution();
+
+    /**
+     * @brief isEnabled checks if the controller changes scale
+     * @return true if it is enabled
+     */
+    bool isEnabled() { return target > 0; }
+
+    /**
+     * @brief setMaxScale sets the highest allowed scale
+     * @param maxScale is scale chosen by user
+     */
+    void setMaxScale(float maxScale);
+
+    /**
+     * @brief setTarget sets wanted frame time
+     * @param frameTime is wanted frame time in milliseconds, 0 disables controller
+     * @param minScale is the lowest allowed scale
+     */
+    void setTarget(float frameTime, float minScale);
+
+    /**
+     * @brief update counts new scale from measured frame
+     * @param frameTime is measured frame time in milliseconds
+     * @param scale is current scale
+     * @return scale to use
+     */
+    float update(float frameTime, float scale);
+
+private:
+    float target;       ///< Wanted frame time
+    float minScale;     ///< The lowest allowed scale
+    float maxScale;     ///< The highest allowed scale
+    float sum;          ///< Sum of measured times in window
+    int count;          ///< Amount of measured times in window
+};
+
+#endif // RESOLUTION_H
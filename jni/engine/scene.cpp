@@ -8,13 +8,18 @@
 ///----------------------------------------------------------------------------------------
 
 #include <algorithm>
+#include <string.h>
+#include "engine/profiler.h"
 #include "engine/scene.h"
 #include "input/airacer.h"
-#include "input/keyboard.h"
+#include "input/recorder.h"
+#include "input/replay.h"
 #include "physics/bullet/bullet.h"
+#include "renderers/null/nullrenderer.h"
+#ifndef HEADLESS_ONLY
+#include "input/keyboard.h"
 #include "renderers/opengl/gles20.h"
-#include "renderers/opengl/glsl.h"
-#include "renderers/opengl/gltexture.h"
+#endif
 
 scene* sc = 0; ///< Instance of itself for static access
 pthread_mutex_t scene::dataMutex = PTHREAD_MUTEX_INITIALIZER;
@@ -31,13 +36,22 @@ bool comparator(const id3d& a, const id3d& b)
 /**
  * @brief Constructor loads scene from Open4speed config file
  * @param filename is scene configuration file (o4scfg)
+ * @param headless is true to run without graphical context
  */
-scene::scene(std::string filename)
+scene::scene(std::string filename, bool headless)
 {
-    /// set key objects
-    controller = new keyboard(); //destroyed by car class
+    /// set key objects, build without graphical libraries has null renderer only
+#ifdef HEADLESS_ONLY
+    headless = true;
+#endif
+    this->headless = headless;
     physic = new bullet();
-    xrenderer = new gles20();
+    if (headless)
+        xrenderer = new nullrenderer();
+#ifndef HEADLESS_ONLY
+    else
+        xrenderer = new gles20();
+#endif
     sc = this;
 
     /// load track
@@ -45,7 +59,16 @@ scene::scene(std::string filename)
     std::string p = f->path();
     delete f;
     loadingThreadsCount = 0;
-    currentFrame = 0;
+    animationCounter = 0;
+    deterministic = false;
+    inputFile = 0;
+    shadowMode = SHADOW_VOLUME;
+    for (int i = 0; i < LOD_COUNT; i++)
+    {
+        lod[i].cars = 0;
+        lod[i].switches = 0;
+        lod[i].time = 0;
+    }
     directionY = 0;
     std::vector<std::string> atributes = getList("", filename);
     shaderPath = p + getConfigStr("shaders", atributes);
@@ -75,18 +98,6 @@ scene::scene(std::string filename)
                 if (i == trackIndex)
                     e.push_back(value);
             }
-            for (int j = 0; j < edgeCount; j++)
-            {
-                edge value;
-                value.a.x = e[j].b.x;
-                value.a.y = e[j].b.y;
-                value.a.z = e[j].b.z;
-                value.b.x = e[j].a.x;
-                value.b.y = e[j].a.y;
-                value.b.z = e[j].a.z;
-                if (i == trackIndex)
-                    e.push_back(value);
-            }
         }
         delete f;
     }
@@ -98,6 +109,10 @@ scene::scene(std::string filename)
         e.push_back( edg );
     }
 
+    /// compile shaders of track before race, streamed parts then do not wait for compiler
+    if (!trackdata)
+        warmupShaders(e);
+
     /// load sky
     skydome = getModel(p + getConfigStr("sky_model", atributes));
 
@@ -107,45 +122,48 @@ scene::scene(std::string filename)
     model* skin = getModel(getConfigStr("skin_model", carAt));
     model* wheel = getModel(getConfigStr("wheel_model", carAt));
 
-    addCar(new car(controller, &e, cfgFile, skin, wheel));
+    trackGraph = new track(e, getConfig("finish", atributes));
+    aiGroup = new aigroup();
+
+    /// there is no keyboard without window, player car is driven by AI
+    if (headless)
+        controller = new airacer(aiGroup); //destroyed by car class
+#ifndef HEADLESS_ONLY
+    else
+        controller = new keyboard(); //destroyed by car class
+#endif
+    addCar(new car(controller, trackGraph, cfgFile, skin, wheel));
+    if (headless)
+        ((airacer*)controller)->init(getCar(0));
 
     /// load race informations
     getCar(0)->lapsToGo = getConfig("laps", atributes);
-    getCar(0)->finishEdge = getConfig("finish", atributes);
-    getCar(0)->currentEdgeIndex = getConfig("race_start", atributes);
-    if (!getCar(0)->edges.empty())
+    if (trackGraph->getEdgeCount() > 0)
     {
-      getCar(0)->setStart(getCar(0)->edges[getConfig("race_start", atributes)], 0);
+      getCar(0)->setStart(getConfig("race_start", atributes), 0);
 
       /// load opponents
       int opponentCount = getConfig("opponent_count", atributes);
       for (int i = 0; i < opponentCount; i++)
       {
           /// racer ai
-          airacer* ai = new airacer();
+          airacer* ai = new airacer(aiGroup);
           cfgFile = p + getConfigStr("opponent" + str(i + 1) + "_car", atributes);
           carAt = getList("", cfgFile);
           skin = getModel(getConfigStr("skin_model", carAt));
           wheel = getModel(getConfigStr("wheel_model", carAt));
-          addCar(new car(ai, &e, cfgFile, skin, wheel));
+          addCar(new car(ai, trackGraph, cfgFile, skin, wheel));
           ai->init(getCar(i + 1));
-          getCar(i + 1)->finishEdge = getCar(0)->finishEdge;
           getCar(i + 1)->lapsToGo = getCar(0)->lapsToGo;
           int move = (i % 2) * 2 - 1;
-          getCar(i + 1)->setStart(getCar(i + 1)->edges[getConfig("race_start", atributes)], move * 4);
-          getCar(i + 1)->currentEdgeIndex = getConfig("race_start", atributes);
+          getCar(i + 1)->setStart(getConfig("race_start", atributes), move * 4);
       }
     }
 
     /// load water
     water = getModel("#assets/cars/fx/water.o4s");
-    for (int i = 0; i < WATER_EFF_LENGTH; i++)
-    {
-        eff[i].vertices = new float[4095 * 3];
-        eff[i].coords = new float[4095 * 2];
-        eff[i].count = 0;
-        eff[i].frame = 0;
-    }
+    waterEffect = new particles(WATER_EFF_LENGTH);
+    waterShader = getShader("particle");
 
     /// create instance of physical engine
     id3d id;
@@ -156,6 +174,8 @@ scene::scene(std::string filename)
         physic->addModel(trackdata, id);
     for (unsigned int i = 0; i < getCarCount(); i++)
         physic->addCar(getCar(i));
+    setPhysicsThreads(getConfig("physics_threads", atributes));
+    setThreadedAI(getConfig("ai_thread", atributes) > 0);
     if (!trackdata)
         loadingLoop((void*)1);
 }
@@ -170,11 +190,17 @@ scene::~scene()
     pthread_mutex_unlock(&sc->loadMutex);
     printf("Active threads: %d\n", loadingThreadsCount);
 
+    /// AI worker reads track graph
+    delete aiGroup;
+
     while (!cars.empty())
     {
         delete cars[cars.size() - 1];
         cars.pop_back();
     }
+    if (inputFile)
+        fclose(inputFile);
+    delete trackGraph;
     for (std::map<std::string, model*>::const_iterator it = models.begin(); it != models.end(); ++it)
         delete it->second;
     models.clear();
@@ -185,12 +211,7 @@ scene::~scene()
         delete it->second;
     textures.clear();
 
-    for (int i = 0; i < WATER_EFF_LENGTH; i++)
-    {
-        delete[] eff[i].vertices;
-        delete[] eff[i].coords;
-    }
-
+    delete waterEffect;
     delete physic;
     delete xrenderer;
 }
@@ -203,6 +224,7 @@ void scene::addCar(car* c)
 {
     cars.push_back(c);
     c->index = getCarCount();
+    standings.push_back(c->index - 1);
 }
 
 /**
@@ -224,6 +246,19 @@ unsigned int scene::getCarCount()
     return cars.size();
 }
 
+/**
+ * @brief getPlace gets race position of car
+ * @param index is index of car
+ * @return place starting from 1
+ */
+int scene::getPlace(int index)
+{
+    for (unsigned int i = 0; i < standings.size(); i++)
+        if (standings[i] == index)
+            return i + 1;
+    return 0;
+}
+
 /**
  * @brief getModel gets model
  * @param filename is path and name of file to load
@@ -278,7 +313,7 @@ shader* scene::getShader(std::string name)
     std::vector<std::string> frag_atributes = getList("FRAG", filename);
 
     /// create shader from code
-    shader* instance = new glsl(vert_atributes, frag_atributes);
+    shader* instance = xrenderer->createShader(vert_atributes, frag_atributes);
     pthread_mutex_lock(&dataMutex);
     shaders[name] = instance;
     pthread_mutex_unlock(&dataMutex);
@@ -310,7 +345,10 @@ texture* scene::getTexture(std::string filename)
     /// create new instance
     if (strcmp(getExtension(filename).c_str(), "png") == 0)
     {
-      texture* instance = new gltexture(texture::loadPNG(getFile(filename)));
+      /// renderer without graphical context needs only size and transparency
+      file* f = getFile(filename);
+      Texture raster = headless ? pngdecoder::readHeader(f) : pngdecoder::decode(f);
+      texture* instance = xrenderer->createTexture(raster);
       pthread_mutex_lock(&dataMutex);
       textures[filename] = instance;
       pthread_mutex_unlock(&dataMutex);
@@ -320,20 +358,28 @@ texture* scene::getTexture(std::string filename)
         /// get animation frame count
         std::string ext = getExtension(filename);
         int count = (ext[1] - '0') * 10 + ext[2] - '0';
-        char file[255];
-        strcpy(file, filename.c_str());
+        char frame[255];
+        strcpy(frame, filename.c_str());
 
-        /// load all sequence images
-        std::vector<texture*> anim;
+        /// load all sequence images, they are decoded in parallel
+        std::vector<file*> files;
         for (int i = 0; i <= count; i++)
         {
-            file[strlen(file) - 1] = i % 10 + '0';
-            file[strlen(file) - 2] = i / 10 + '0';
-            texture* instance = new gltexture(texture::loadPNG(getFile(file)));
-            anim.push_back(instance);
+            frame[strlen(frame) - 1] = i % 10 + '0';
+            frame[strlen(frame) - 2] = i / 10 + '0';
+            files.push_back(getFile(frame));
         }
+        std::vector<Texture> frames;
+        if (headless)
+            for (unsigned int i = 0; i < files.size(); i++)
+                frames.push_back(pngdecoder::readHeader(files[i]));
+        else
+            frames = pngdecoder::decode(files);
 
-        texture* instance = new gltexture(anim);
+        /// sequence is packed into one texture, frame is chosen by texture coordinates
+        int columns, rows;
+        texture* instance = xrenderer->createTexture(texture::createAtlas(frames, &columns, &rows));
+        instance->setFrames(count + 1, columns, rows);
         pthread_mutex_lock(&dataMutex);
         textures[filename] = instance;
         pthread_mutex_unlock(&dataMutex);
@@ -368,13 +414,31 @@ texture* scene::getTexture(float r, float g, float b)
         return instance;
     }
 
-    texture* instance = new gltexture(texture::createRGB(1, 1, r, g, b));
+    texture* instance = xrenderer->createTexture(texture::createRGB(1, 1, r, g, b));
     pthread_mutex_lock(&dataMutex);
     textures[filename] = instance;
     pthread_mutex_unlock(&dataMutex);
     return instance;
 }
 
+/**
+ * @brief getFrameLog gets draw calls and state changes of last frame
+ * @return frame summary, it is empty if renderer does not count frames
+ */
+frameLog scene::getFrameLog()
+{
+    return xrenderer->getFrameLog();
+}
+
+/**
+ * @brief adaptResolution changes render scale by measured frame time
+ * @param frameTime is measured time of frame rendering in milliseconds
+ */
+void scene::adaptResolution(float frameTime)
+{
+    xrenderer->adaptResolution(frameTime);
+}
+
 /**
  * @brief initRenderer inits renderer
  * @param w is screen width
@@ -387,12 +451,41 @@ void scene::initRenderer(int w, int h, float a)
     xrenderer->init(w, h, a);
 }
 
+/**
+ * @brief recordInput records state of all car controls into file every tick, it also
+ * turns on deterministic mode
+ * @param filename is path of output file
+ * @return true if file was opened
+ */
+bool scene::recordInput(std::string filename)
+{
+    if (inputFile)
+        return false;
+    inputFile = fopen(filename.c_str(), "wb");
+    if (!inputFile)
+    {
+        loge("Unable to write input record:", filename);
+        return false;
+    }
+
+    /// header with amount of cars
+    unsigned char header[6] = {0, 0, 0, 0, INPUT_FILE_VERSION, (unsigned char)getCarCount()};
+    memcpy(header, INPUT_FILE_MAGIC, 4);
+    fwrite(header, 1, 6, inputFile);
+    for (unsigned int i = 0; i < getCarCount(); i++)
+        getCar(i)->control = new recorder(getCar(i)->control, inputFile);
+    setDeterministic(true);
+    return true;
+}
+
 /**
  * @brief render shows scene
  * @param cameraCar is index of car which should be traced by camera
  */
 void scene::render(int cameraCar)
 {
+    profiler::frame();
+    PROFILE("scene::render");
     setCamera(cameraCar);
     xrenderer->rtt(true);
 
@@ -403,14 +496,15 @@ void scene::render(int cameraCar)
     xrenderer->renderModel(skydome);
     xrenderer->popMatrix();
 
-    /// render track
+    /// render track, its parts are in scene root
     xrenderer->enable[1] = false;
+    xrenderer->staticRoot = true;
     if (trackdata)
         xrenderer->renderModel(trackdata);
     else
     {
         // start loading thread
-        bool found = lastUpdate == getVisibility(false)[0];
+        bool found = deterministic || (lastUpdate == getVisibility(false)[0]);
         if (pthread_mutex_trylock(&loadMutex) == 0)
         {
             if (!found)
@@ -430,14 +524,17 @@ void scene::render(int cameraCar)
                 xrenderer->renderModel(trackdataCulled[*it]);
         pthread_mutex_unlock(&dataMutex);
     }
+    xrenderer->staticRoot = false;
 
-    /// render cars
+    /// render cars, every car shows different frame of nitro animation
     xrenderer->enable[2] = false;
+    animationCounter++;
     for (int i = getCarCount() - 1; i >= 0; i--)
     {
         ///render car skin
         xrenderer->pushMatrix();
         xrenderer->multMatrix(getCar(i)->transform[0].value);
+        xrenderer->animationFrame = animationCounter / ANIMATION_SLOWDOWN + i;
         xrenderer->enable[1] = getCar(i)->control->getNitro() && (getCar(i)->n2o > 1);
         xrenderer->enable[9] = getCar(i)->control->getBrake() > 0.005f;
         xrenderer->renderModel(getCar(i)->skin);
@@ -456,134 +553,257 @@ void scene::render(int cameraCar)
     }
 
     /// render shadows
-    for (int i = getCarCount() - 1; i >= 0; i--)
-    {
-        ///render car skin
-        xrenderer->pushMatrix();
-        xrenderer->multMatrix(getCar(i)->transform[0].value);
-        xrenderer->renderShadow(getCar(i)->skin);
-        xrenderer->popMatrix();
-    }
+    if (shadowMode == SHADOW_BLOB)
+        renderBlobShadows();
+    else
+        for (int i = getCarCount() - 1; i >= 0; i--)
+        {
+            ///render car skin
+            xrenderer->pushMatrix();
+            xrenderer->multMatrix(getCar(i)->transform[0].value);
+            xrenderer->renderShadow(getCar(i)->skin);
+            xrenderer->popMatrix();
+        }
 
     /// render smoke effects
-    for (int k = 0; k < WATER_EFF_LENGTH; k++)
+    for (int i = 0; i < waterEffect->getCount();)
     {
-        if (physic->active || (k != (currentFrame + WATER_EFF_LENGTH - 1) % WATER_EFF_LENGTH))
-        {
-            water->models[0].texture2D->setFrame(eff[k].frame);
-            xrenderer->renderDynamic(eff[k].vertices, 0, eff[k].coords, water->models[0].material, water->models[0].texture2D, eff[k].count / 3);
-        }
+        /// particles of the same age share frame of texture animation
+        int last = waterEffect->getGroup(i);
+        xrenderer->animationFrame = waterEffect->age[i];
+        xrenderer->renderParticles(&waterEffect->x[i], &waterEffect->y[i], &waterEffect->z[i], last - i, waterShader, &water->models[0]);
+        i = last;
     }
     xrenderer->popMatrix();
     // render RTT
     xrenderer->rtt(false);
 }
 
+/**
+ * @brief renderBlobShadows renders shadows of all cars by one draw call
+ */
+void scene::renderBlobShadows()
+{
+    static const int order[6] = {0, 1, 3, 0, 3, 2};
+    static const float coords[8] = {0, 0, 1, 0, 0, 1, 1, 1};
+    shadowVertices.clear();
+    shadowCoords.clear();
+    for (unsigned int i = 0; i < getCarCount(); i++)
+    {
+        /// corners of blob are contact points of wheels, wheels are ordered back left,
+        /// back right, front left and front right
+        car* c = getCar(i);
+        float* up = &c->transform[0].value[4];
+        float lift = (c->wheel->aabb.max.y - c->wheel->aabb.min.y) * 0.5f - SHADOW_BLOB_LIFT;
+        glm::vec3 corner[4];
+        glm::vec3 center = glm::vec3(0);
+        for (int j = 0; j < 4; j++)
+        {
+            float* wheel = &c->transform[j + 1].value[12];
+            corner[j] = glm::vec3(wheel[0] - up[0] * lift, wheel[1] - up[1] * lift, wheel[2] - up[2] * lift);
+            center += corner[j] * 0.25f;
+        }
+
+        /// blob is bigger than wheelbase to cover whole body
+        for (int j = 0; j < 6; j++)
+        {
+            glm::vec3 v = center + (corner[order[j]] - center) * SHADOW_BLOB_SCALE;
+            shadowVertices.push_back(v.x);
+            shadowVertices.push_back(v.y);
+            shadowVertices.push_back(v.z);
+            shadowCoords.push_back(coords[order[j] * 2 + 0]);
+            shadowCoords.push_back(coords[order[j] * 2 + 1]);
+        }
+    }
+    if (!shadowVertices.empty())
+        xrenderer->renderShadows(&shadowVertices[0], &shadowCoords[0], shadowVertices.size() / 9);
+}
+
+/**
+ * @brief replayInput controls all cars by file recorded by recordInput, it also turns on
+ * deterministic mode
+ * @param filename is path of recorded file
+ * @return true if file was opened and it fits the scene
+ */
+bool scene::replayInput(std::string filename)
+{
+    if (inputFile)
+        return false;
+    inputFile = fopen(filename.c_str(), "rb");
+    if (!inputFile)
+    {
+        loge("Unable to read input record:", filename);
+        return false;
+    }
+
+    /// check header
+    unsigned char header[6];
+    if ((fread(header, 1, 6, inputFile) != 6) || (memcmp(header, INPUT_FILE_MAGIC, 4) != 0) ||
+        (header[4] != INPUT_FILE_VERSION) || (header[5] != getCarCount()))
+    {
+        loge("Invalid input record:", filename);
+        fclose(inputFile);
+        inputFile = 0;
+        return false;
+    }
+    for (unsigned int i = 0; i < getCarCount(); i++)
+        getCar(i)->control = new replay(getCar(i)->control, inputFile);
+    setDeterministic(true);
+    return true;
+}
+
+/**
+ * @brief setDeterministic sets scene into reproducible mode, track parts are loaded
+ * synchronously by player position and simulation is reset into the same state
+ * @param on is true to enable deterministic mode
+ */
+void scene::setDeterministic(bool on)
+{
+    deterministic = on;
+    physic->setDeterministic(on);
+}
+
+/**
+ * @brief setDynamicResolution enables changing render scale by frame time, scale from
+ * initRenderer is maximum
+ * @param frameTime is wanted time of frame rendering in milliseconds, 0 disables it
+ * @param minAliasing is the lowest allowed render scale
+ */
+void scene::setDynamicResolution(float frameTime, float minAliasing)
+{
+    xrenderer->setDynamicResolution(frameTime, minAliasing);
+}
+
 /**
  * @brief update updates scene physics
  */
 void scene::update()
 {
+    PROFILE("scene::update");
     if (physic->active)
     {
-        /// update cars
+        /// load track parts synchronously to keep simulation reproducible
+        if (deterministic && !trackdata && !(lastUpdate == getVisibility(false)[0]))
+            loadingLoop((void*)1);
+
+        /// update cars, decisions of all AI racers are made together
+        for (int i = 0; i < LOD_COUNT; i++)
+            lod[i].cars = 0;
+        aiGroup->update();
         for (unsigned int i = 0; i < getCarCount(); i++)
         {
-            /// update current edge for navigation
+            /// read controls of current tick
             car* c = getCar(i);
-            if (!physic->locked)
+            double time = getTime();
+            c->control->update();
+
+            /// update current edge for navigation, track without edges has no navigation
+            if (!physic->locked && (c->edges->getEdgeCount() > 0))
             {
-                bool out = distance(c->pos, getCar(0)->pos) > 300;
-                float update = out ? 5 : c->control->getUpdate();
-                if ((distance(c->pos, c->currentEdge.b) < update)
-                        && (fabsf(c->currentEdge.b.y - c->pos.y) < 30))
+                float update = c->kinematic ? LOD_UPDATE : c->control->getUpdate();
+                glm::vec3 end = c->edges->getEnd(c->currentEdge);
+                if ((distance(c->pos, end) < update) && (fabsf(end.y - c->pos.y) < 30))
                 {
-                    std::vector<int> nEdges = nextEdge(c->edges, c->currentEdge);
-                    if (nEdges.size() > 0)
-                        c->currentEdge = c->edges[nEdges[0]];
-
+                    int next = c->edges->getNext(c->currentEdge);
+                    if (next >= 0)
+                        c->currentEdge = next;
+                } else if (c->edges->getSegmentDistance(c->currentEdge, c->pos) > TRACK_LOST_DISTANCE)
+                {
+                    /// retarget car knocked off course onto the nearest part of race path
+                    int nearest = c->edges->getNearest(c->pos, TRACK_SEARCH_RADIUS, true);
+                    if (nearest >= 0)
+                        c->currentEdge = nearest;
                 }
                 if (i != 0)
                 {
-                    if (out)
+                    /// switch physics level of detail
+                    float dst = distance(c->pos, getCar(0)->pos);
+                    if (!c->kinematic && (dst > LOD_FAR))
+                    {
+                        physic->setCarKinematic(c, true);
+                        lod[LOD_KINEMATIC].switches++;
+                    }
+
+                    /// move distant car along track
+                    if (c->kinematic)
                     {
-                      int rnd = (int)(i * 17) % 10;
-                      float speed = (1.5f + rnd * 0.1f) * (1 - c->control->getBrake());
-                      c->pos += glm::normalize(c->currentEdge.b - c->pos) * speed;
-                      c->rot = angle(c->currentEdge.b, c->currentEdge.a) * 180.0f / 3.14f;
-                      physic->resetCar(c, false);
-                      continue;
+                        int rnd = (int)(i * 17) % 10;
+                        float speed = (LOD_SPEED + rnd * LOD_SPEED_VARIATION) * (1 - c->control->getBrake());
+                        c->speed += (speed - c->speed) * LOD_ACCELERATION;
+                        glm::vec3 target = c->edges->getEnd(c->currentEdge);
+                        c->pos += glm::normalize(target - c->pos) * c->speed / (float)SPEED_ASPECT;
+                        c->rot = angle(target, c->edges->getStart(c->currentEdge)) * 180.0f / 3.14f;
+                        if (dst < LOD_NEAR)
+                        {
+                            physic->setCarKinematic(c, false);
+                            lod[LOD_FULL].switches++;
+                        }
                     }
                 }
             }
             physic->updateCar(c);
             c->update(distance(getCar(0)->pos, c->pos));
+            lod[c->kinematic ? LOD_KINEMATIC : LOD_FULL].cars++;
+            lod[c->kinematic ? LOD_KINEMATIC : LOD_FULL].time += getTime() - time;
 
             // reset car if needed
             if (c->resetAllowed && c->resetRequested)
             {
                 for (unsigned int i = 0; i < getCarCount(); i++)
                 {
-                    if (i != c->index - 1)
-                        if (glm::length(c->currentEdge.a - getCar(i)->pos) < 10)
+                    if ((i != c->index - 1) && (c->edges->getEdgeCount() > 0))
+                        if (glm::length(c->edges->getStart(c->currentEdge) - getCar(i)->pos) < 10)
                             return;
                 }
                 physic->resetCar(c);
             }
         }
 
-        /// update dynamic objects
-        id3d id;
-        id.x = 0;
-        id.y = 0;
-        id.z = 0;
-        if (trackdata)
+        /// update scene
+        physic->updateWorld();
+
+        /// update standings, order changes rarely so insertion sort is used
+        for (unsigned int i = 1; i < standings.size(); i++)
         {
-            for (unsigned int i = 0; i < trackdata->models.size(); i++)
-                if (trackdata->models[i].dynamic)
-                    physic->getTransform(trackdata->models[i].dynamicID, trackdata->models[i].dynamicMat, id);
+            int value = standings[i];
+            int j = i - 1;
+            while ((j >= 0) && (getCar(standings[j])->toFinish > getCar(value)->toFinish))
+            {
+                standings[j + 1] = standings[j];
+                j--;
+            }
+            standings[j + 1] = value;
         }
 
-        /// update scene
-        physic->updateWorld();
+        /// state of cars is final, AI racers may plan next tick
+        aiGroup->prepare();
     }
 
     // update water
-    eff[currentFrame].count = 0;
+    waterEffect->update();
     for (int i = getCarCount() - 1; i >= 0; i--)
     {
         float g = getCar(i)->rot * 3.14 / 180.0 - directionY;
         float effect = fabs(getCar(i)->speed) * fabs(getCar(i)->speed * (g + getCar(i)->control->getBrake() * 5.0)) * 0.001f;
         effect = fmax(effect, effect * 0.05 + getCar(i)->prevEffect * 0.95);
         getCar(i)->prevEffect = effect;
+        if (!physic->active)
+            continue;
+
+        /// particles are emitted in line behind wheel
+        float dx = sin(getCar(i)->rot * 3.14 / 180) * 0.03f;
+        float dz = cos(getCar(i)->rot * 3.14 / 180) * 0.03f;
         for (int j = 1; j <= 2; j++)
         {
-            if (physic->active)
+            float* wheel = getCar(i)->transform[j].value;
+            for (int k = 0; k < fmin(effect - 5, 5); k++)
             {
-                for (int k = 0; k < fmin(effect - 5, 5); k++)
-                {
-                    float x = getCar(i)->transform[j].value[12] + (rand() % 50 - 25) * 0.03f + sin(getCar(i)->rot * 3.14 / 180) * k * 0.03f;
-                    float y = getCar(i)->transform[j].value[13] - 0.1f;
-                    float z = getCar(i)->transform[j].value[14] + (rand() % 50 - 25) * 0.03f + cos(getCar(i)->rot * 3.14 / 180) * k * 0.03f;
-                    for (unsigned int l = 0; l < water->models[0].count * 3; l++)
-                    {
-                        eff[currentFrame].vertices[eff[currentFrame].count * 3 + 0] = x;
-                        eff[currentFrame].vertices[eff[currentFrame].count * 3 + 1] = y;
-                        eff[currentFrame].vertices[eff[currentFrame].count * 3 + 2] = z;
-                        eff[currentFrame].coords[eff[currentFrame].count * 2 + 0] = water->models[0].coords[l * 2 + 0];
-                        eff[currentFrame].coords[eff[currentFrame].count * 2 + 1] = water->models[0].coords[l * 2 + 1];
-                        eff[currentFrame].count++;
-                    }
-                }
+                float x = wheel[12] + waterEffect->random() * 0.75f + dx * k;
+                float z = wheel[14] + waterEffect->random() * 0.75f + dz * k;
+                waterEffect->emit(x, wheel[13] - 0.1f, z);
             }
         }
     }
-    for (int k = 0; k < WATER_EFF_LENGTH; k++)
-        eff[k].frame++;
-    eff[currentFrame].frame = 0;
-    currentFrame++;
-    if (currentFrame >= WATER_EFF_LENGTH)
-        currentFrame = 0;
 }
 
 /**
@@ -595,10 +815,11 @@ std::vector<id3d> scene::getVisibility(bool directional)
 {
     pthread_mutex_lock(&sc->dataMutex);
     std::vector<id3d> output;
-    int steps = 3;
-    int cx = camera.x / CULLING_DST;
-    int cy = camera.y / CULLING_DST;
-    int cz = camera.z / CULLING_DST;
+    int steps = CULLING_STEPS;
+    glm::vec3 center = deterministic && !directional ? getCar(0)->pos : camera;
+    int cx = center.x / CULLING_DST;
+    int cy = center.y / CULLING_DST;
+    int cz = center.z / CULLING_DST;
     id3d id;
     id.x = cx;
     id.y = cy;
@@ -687,6 +908,50 @@ void scene::setCamera(int cameraCar)
     pthread_mutex_unlock(&dataMutex);
 }
 
+/**
+ * @brief warmupShaders compiles shaders of track parts along race path
+ * @param edges is race path
+ */
+void scene::warmupShaders(std::vector<edge> edges)
+{
+    /// find all parts which could be loaded by culling along the path
+    std::map<id3d, bool> parts;
+    for (unsigned int i = 0; i < edges.size(); i++)
+    {
+        float length = glm::length(edges[i].b - edges[i].a);
+        int samples = (int)(length / CULLING_DST) + 1;
+        for (int j = 0; j <= samples; j++)
+        {
+            glm::vec3 center = edges[i].a + (edges[i].b - edges[i].a) * (j / (float)samples);
+            id3d id;
+            for (int x = -CULLING_STEPS; x <= CULLING_STEPS; x++)
+                for (int y = -CULLING_STEPS; y <= CULLING_STEPS; y++)
+                    for (int z = -CULLING_STEPS; z <= CULLING_STEPS; z++)
+                    {
+                        id.x = (int)(center.x / CULLING_DST) + x;
+                        id.y = (int)(center.y / CULLING_DST) + y;
+                        id.z = (int)(center.z / CULLING_DST) + z;
+                        parts[id] = true;
+                    }
+        }
+    }
+
+    /// collect materials of existing parts, every shader is compiled once
+    std::map<std::string, bool> names;
+    for (std::map<id3d, bool>::const_iterator it = parts.begin(); it != parts.end(); ++it)
+    {
+        std::string name = id2str(it->first);
+        if (fileExists(name))
+        {
+            std::vector<std::string> list = model::getShaders(name);
+            for (unsigned int i = 0; i < list.size(); i++)
+                names[list[i]] = true;
+        }
+    }
+    for (std::map<std::string, bool>::const_iterator it = names.begin(); it != names.end(); ++it)
+        getShader(it->first);
+}
+
 /**
  * @brief loadingLoop is cycle for loading data on background
  * @param ptr is 1 for non pthread calling
@@ -694,6 +959,7 @@ void scene::setCamera(int cameraCar)
  */
 void* scene::loadingLoop(void *ptr)
 {
+    PROFILE("scene::loadingLoop");
     // mark everything for deleting
     std::map<id3d, bool> toDeleteId;
     pthread_mutex_lock(&sc->dataMutex);
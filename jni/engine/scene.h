@@ -10,23 +10,45 @@
 #ifndef SWITCH_H
 #define SWITCH_H
 
+#include <stdio.h>
 #include <string>
 #include "engine/io.h"
 #include "engine/model.h"
+#include "engine/particles.h"
+#include "input/aigroup.h"
 #include "interfaces/input.h"
 #include "interfaces/materialLoader.h"
 #include "interfaces/physics.h"
 #include "interfaces/renderer.h"
 
-struct Dynamic
+/**
+ * @brief The physics level of detail counter struct
+ */
+struct lodCounter
 {
-    float* vertices;
-    float* coords;
-    int count;
-    int frame;
+    int cars;       ///< Amount of cars in level
+    int switches;   ///< Amount of switches into level
+    double time;    ///< Time spent by updating cars in level (in ms)
 };
 
+#define ANIMATION_SLOWDOWN 2
 #define CULLING_DST 100
+#define CULLING_STEPS 3
+#define LOD_ACCELERATION 0.05f
+#define LOD_COUNT 2
+#define LOD_FAR 300
+#define LOD_FULL 0
+#define LOD_KINEMATIC 1
+#define LOD_NEAR 250
+#define LOD_SPEED 75
+#define LOD_SPEED_VARIATION 5
+#define LOD_UPDATE 5
+#define SHADOW_BLOB 1
+#define SHADOW_BLOB_LIFT 0.05f
+#define SHADOW_BLOB_SCALE 1.6f
+#define SHADOW_VOLUME 0
+#define TRACK_LOST_DISTANCE 30
+#define TRACK_SEARCH_RADIUS 100
 #define WATER_EFF_LENGTH 5
 
 /**
@@ -39,13 +61,14 @@ public:
     /**
      * @brief Constructor loads scene from Open4speed config file
      * @param filename is scene configuration file (o4scfg)
+     * @param headless is true to run without graphical context
      */
-    scene(std::string filename);
+    scene(std::string filename, bool headless = false);
 
     /**
      * @brief model destructor
      */
-    ~scene();
+    virtual ~scene();
 
     /**
      * @brief addCar adds car into scene
@@ -53,6 +76,12 @@ public:
      */
     void addCar(car* c);
 
+    /**
+     * @brief adaptResolution changes render scale by measured frame time
+     * @param frameTime is measured time of frame rendering in milliseconds
+     */
+    void adaptResolution(float frameTime);
+
     /**
      * @brief getCar gets car from scene
      * @param index is index of car
@@ -66,6 +95,26 @@ public:
      */
     unsigned int getCarCount();
 
+    /**
+     * @brief getLodCounter gets cost counter of physics level of detail
+     * @param level is LOD_FULL or LOD_KINEMATIC
+     * @return counter of level
+     */
+    lodCounter getLodCounter(int level) { return lod[level]; }
+
+    /**
+     * @brief getFrameLog gets draw calls and state changes of last frame
+     * @return frame summary, it is empty if renderer does not count frames
+     */
+    frameLog getFrameLog();
+
+    /**
+     * @brief getPlace gets race position of car
+     * @param index is index of car
+     * @return place starting from 1
+     */
+    int getPlace(int index);
+
     /**
      * @brief getModel gets model
      * @param filename is path and name of file to load
@@ -104,12 +153,28 @@ public:
      */
     void initRenderer(int w, int h, float a);
 
+    /**
+     * @brief recordInput records state of all car controls into file every tick, it also
+     * turns on deterministic mode
+     * @param filename is path of output file
+     * @return true if file was opened
+     */
+    bool recordInput(std::string filename);
+
     /**
      * @brief render shows scene
      * @param cameraCar is index of car which should be traced by camera
      */
     void render(int cameraCar);
 
+    /**
+     * @brief replayInput controls all cars by file recorded by recordInput, it also turns on
+     * deterministic mode
+     * @param filename is path of recorded file
+     * @return true if file was opened and it fits the scene
+     */
+    bool replayInput(std::string filename);
+
     /**
      * @brief resetCar resets car if it is on roof
      * @param index is index of car to reset
@@ -117,12 +182,45 @@ public:
      */
     void resetCar(int index, bool total) { physic->resetCar(getCar(index), total); }
 
+    /**
+     * @brief setDeterministic sets scene into reproducible mode, track parts are loaded
+     * synchronously by player position and simulation is reset into the same state
+     * @param on is true to enable deterministic mode
+     */
+    void setDeterministic(bool on);
+
+    /**
+     * @brief setDynamicResolution enables changing render scale by frame time, scale from
+     * initRenderer is maximum
+     * @param frameTime is wanted time of frame rendering in milliseconds, 0 disables it
+     * @param minAliasing is the lowest allowed render scale
+     */
+    void setDynamicResolution(float frameTime, float minAliasing);
+
     /**
      * @brief setPhysicsLocked lock/unlock physics movement
      * @param locked is true to lock movement
      */
     void setPhysicsLocked(bool locked) { physic->locked = locked; }
 
+    /**
+     * @brief setPhysicsThreads sets amount of threads used by physics
+     * @param count is amount of threads, 1 for serial simulation
+     */
+    void setPhysicsThreads(int count) { physic->setThreads(count); }
+
+    /**
+     * @brief setShadowMode sets way of rendering car shadows
+     * @param mode is SHADOW_VOLUME for stencil shadows or SHADOW_BLOB for one pass blobs
+     */
+    void setShadowMode(int mode) { shadowMode = mode; }
+
+    /**
+     * @brief setThreadedAI enables computing of AI racers on worker thread
+     * @param on is true to use worker thread
+     */
+    void setThreadedAI(bool on) { aiGroup->setThreaded(on); }
+
     /**
      * @brief update updates scene physics
      */
@@ -144,12 +242,23 @@ private:
      */
     std::string id2str(id3d id) { return trackPath + "." + str(id.x) + "." + str(id.y) + "." + str(id.z); }
 
+    /**
+     * @brief renderBlobShadows renders shadows of all cars by one draw call
+     */
+    void renderBlobShadows();
+
     /**
      * @brief setCamera sets camera in scene by car
      * @param cameraCar is index of car which should be traced by camera
      */
     void setCamera(int cameraCar);
 
+    /**
+     * @brief warmupShaders compiles shaders of track parts along race path
+     * @param edges is race path
+     */
+    void warmupShaders(std::vector<edge> edges);
+
     /**
      * @brief loadingLoop is cycle for loading data on background
      * @param ptr is unused
@@ -165,6 +274,7 @@ private:
     std::map<std::string, shader*> shaders;   ///< Shaders storage
     std::map<std::string, texture*> textures; ///< Textures storage
     input *controller;                        ///< Instance of control device
+    aigroup *aiGroup;                         ///< Decisions of all AI racers
     physics *physic;                          ///< Physical engine instance
     renderer *xrenderer;                      ///< Renderer instance
     std::string shaderPath;                   ///< Path to shader files
@@ -172,8 +282,16 @@ private:
     /**
      * @brief The scene state
      */
+    int animationCounter;                     ///< Rendered frames for texture animations
     float aspect;                             ///< Screen aspect
-    int currentFrame;                         ///< Frame index
+    bool deterministic;                       ///< Reproducible mode
+    bool headless;                            ///< Running without graphical context
+    FILE* inputFile;                          ///< Recorded or replayed inputs
+    lodCounter lod[LOD_COUNT];                ///< Physics level of detail counters
+    int shadowMode;                           ///< SHADOW_VOLUME or SHADOW_BLOB
+    std::vector<float> shadowVertices;        ///< Vertices of blob shadows
+    std::vector<float> shadowCoords;          ///< Texture coords of blob shadows
+    std::vector<int> standings;               ///< Car indices ordered by distance to finish
     float directionY;                         ///< Camera direction
     int viewDistance;                         ///< Camera view distance
     glm::vec3 camera;                         ///< Camera position
@@ -181,8 +299,10 @@ private:
     model *skydome;                           ///< Skydome model
     model *trackdata;                         ///< Track first model
     model *water;                             ///< Water effect model
-    Dynamic eff[WATER_EFF_LENGTH];            ///< 3D water effect object
+    particles* waterEffect;                   ///< Water particles behind wheels
+    shader* waterShader;                      ///< Shader of water particles
     std::string trackPath;                    ///< Path to 3D model
+    track* trackGraph;                        ///< Graph of race track edges
     std::map<id3d, model*> trackdataCulled;   ///< Culled track model
     static pthread_mutex_t dataMutex;         ///< Lock for multithreading
     static pthread_mutex_t loadMutex;         ///< Lock for multithreading
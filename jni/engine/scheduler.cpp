@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       scheduler.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Frame scheduler which sleeps until next frame and counts how many fixed
+ *             simulation ticks are due, so tick rate does not depend on render rate.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <time.h>
+#include "engine/io.h"
+#include "engine/scheduler.h"
+
+#define SCHEDULER_MAX_TICKS 4
+#define SCHEDULER_RATE_PERIOD 1000
+
+/**
+ * @brief scheduler constructor
+ * @param tickRate is amount of simulation ticks per second
+ * @param renderRate is amount of rendered frames per second
+ */
+scheduler::scheduler(float tickRate, float renderRate)
+{
+    setRates(tickRate, renderRate);
+    nextFrame = getTime();
+    nextTick = nextFrame;
+    lastFrame = nextFrame;
+    rateStart = nextFrame;
+    rateTicks = 0;
+    rateFrames = 0;
+    this->tickRate = 0;
+    this->renderRate = 0;
+    historyCount = 0;
+    historyIndex = 0;
+}
+
+/**
+ * @brief getFrameTime gets percentile of time between frames
+ * @param percentile is value between 0 and 100
+ * @return time in milliseconds
+ */
+float scheduler::getFrameTime(float percentile)
+{
+    int count = historyCount;
+    if (count == 0)
+        return 0;
+    float sorted[SCHEDULER_HISTORY];
+    std::copy(history, history + count, sorted);
+    int index = (int)(percentile / 100.0f * (count - 1) + 0.5f);
+    index = std::max(0, std::min(count - 1, index));
+    std::nth_element(sorted, sorted + index, sorted + count);
+    return sorted[index];
+}
+
+/**
+ * @brief setRates sets wanted rates
+ * @param tickRate is amount of simulation ticks per second
+ * @param renderRate is amount of rendered frames per second
+ */
+void scheduler::setRates(float tickRate, float renderRate)
+{
+    tickPeriod = 1000.0 / tickRate;
+    renderPeriod = 1000.0 / renderRate;
+}
+
+/**
+ * @brief wait sleeps until next frame should be rendered
+ * @return amount of simulation ticks to do before rendering
+ */
+int scheduler::wait()
+{
+    /// sleep until deadline, the deadline moves by period to avoid drifting
+    double now = getTime();
+    if (nextFrame > now)
+    {
+        double sleep = nextFrame - now;
+        timespec t;
+        t.tv_sec = (time_t)(sleep / 1000.0);
+        t.tv_nsec = (long)((sleep - t.tv_sec * 1000.0) * 1000000.0);
+        while (nanosleep(&t, &t) != 0) {}
+        now = getTime();
+    }
+    nextFrame += renderPeriod;
+    if (nextFrame < now)
+        nextFrame = now + renderPeriod;
+
+    /// count due ticks, after long stall the simulation does not try to catch up
+    int ticks = 0;
+    while ((nextTick <= now) && (ticks < SCHEDULER_MAX_TICKS))
+    {
+        nextTick += tickPeriod;
+        ticks++;
+    }
+    if (nextTick <= now)
+        nextTick = now + tickPeriod;
+
+    /// store frame time
+    history[historyIndex] = now - lastFrame;
+    historyIndex = (historyIndex + 1) % SCHEDULER_HISTORY;
+    if (historyCount < SCHEDULER_HISTORY)
+        historyCount++;
+    lastFrame = now;
+
+    /// measure rates
+    rateTicks += ticks;
+    rateFrames++;
+    if (now - rateStart >= SCHEDULER_RATE_PERIOD)
+    {
+        tickRate = rateTicks * 1000.0f / (now - rateStart);
+        renderRate = rateFrames * 1000.0f / (now - rateStart);
+        rateTicks = 0;
+        rateFrames = 0;
+        rateStart = now;
+    }
+    return ticks;
+}
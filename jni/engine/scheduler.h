@@ -0,0 +1,90 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       scheduler.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Frame scheduler which sleeps until next frame and counts how many fixed
+ *             simulation ticks are due, so tick rate does not depend on render rate.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#define SCHEDULER_HISTORY 128
+
+/**
+ * @brief The scheduler class
+ */
+class scheduler
+{
+public:
+
+    /**
+     * @brief scheduler constructor
+     * @param tickRate is amount of simulation ticks per second
+     * @param renderRate is amount of rendered frames per second
+     */
+    scheduler(float tickRate, float renderRate);
+
+    /**
+     * @brief getRenderRate gets rendered frames per second
+     * @return rate of last second
+     */
+    float getRenderRate() { return renderRate; }
+
+    /**
+     * @brief getTickRate gets simulation ticks per second
+     * @return rate of last second
+     */
+    float getTickRate() { return tickRate; }
+
+    /**
+     * @brief getTargetRenderRate gets wanted rendered frames per second
+     * @return amount of frames per second
+     */
+    float getTargetRenderRate() { return 1000.0f / renderPeriod; }
+
+    /**
+     * @brief getTargetTickRate gets wanted simulation ticks per second
+     * @return amount of ticks per second
+     */
+    float getTargetTickRate() { return 1000.0f / tickPeriod; }
+
+    /**
+     * @brief getFrameTime gets percentile of time between frames
+     * @param percentile is value between 0 and 100
+     * @return time in milliseconds
+     */
+    float getFrameTime(float percentile);
+
+    /**
+     * @brief setRates sets wanted rates
+     * @param tickRate is amount of simulation ticks per second
+     * @param renderRate is amount of rendered frames per second
+     */
+    void setRates(float tickRate, float renderRate);
+
+    /**
+     * @brief wait sleeps until next frame should be rendered
+     * @return amount of simulation ticks to do before rendering
+     */
+    int wait();
+
+private:
+    double tickPeriod;                      ///< Time of one tick in milliseconds
+    double renderPeriod;                    ///< Time of one frame in milliseconds
+    double nextFrame;                       ///< Deadline of next frame
+    double nextTick;                        ///< Time of next tick
+    double lastFrame;                       ///< Time of last frame
+    double rateStart;                       ///< Start of rate measuring
+    int rateTicks;                          ///< Ticks since start of rate measuring
+    int rateFrames;                         ///< Frames since start of rate measuring
+    float tickRate;                         ///< Measured ticks per second
+    float renderRate;                       ///< Measured frames per second
+    float history[SCHEDULER_HISTORY];       ///< Times between last frames
+    int historyCount;                       ///< Amount of valid times
+    int historyIndex;                       ///< Index of next written time
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,346 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       track.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Graph of track edges used for navigation of cars. It is built once on
+ *             loading and shared by all cars.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include "engine/track.h"
+
+/**
+ * @brief The start comparator orders edge indices by start point, equal points by index
+ */
+class startComparator
+{
+public:
+    startComparator(const std::vector<edge>& e) : edges(e) {}
+
+    bool operator() (int a, int b) const
+    {
+        const glm::vec3& va = edges[a].a;
+        const glm::vec3& vb = edges[b].a;
+        if (va.x != vb.x)
+            return va.x < vb.x;
+        if (va.y != vb.y)
+            return va.y < vb.y;
+        if (va.z != vb.z)
+            return va.z < vb.z;
+        return a < b;
+    }
+
+private:
+    const std::vector<edge>& edges; ///< Edges to compare
+};
+
+/**
+ * @brief track constructor builds graph, every edge is added in both directions
+ * @param edges is list of track edges, reversed edges get index edges.size() + i
+ * @param finish is index of finish edge
+ */
+track::track(std::vector<edge> edges, int finish)
+{
+    /// add reversed edges
+    unsigned int count = edges.size();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        edge value;
+        value.a = edges[i].b;
+        value.b = edges[i].a;
+        edges.push_back(value);
+    }
+
+    /// store edges as structure of arrays
+    for (unsigned int i = 0; i < edges.size(); i++)
+    {
+        startX.push_back(edges[i].a.x);
+        startY.push_back(edges[i].a.y);
+        startZ.push_back(edges[i].a.z);
+        endX.push_back(edges[i].b.x);
+        endY.push_back(edges[i].b.y);
+        endZ.push_back(edges[i].b.z);
+        length.push_back(glm::length(edges[i].a - edges[i].b));
+    }
+
+    /// sort edges by start point
+    std::vector<int> sorted;
+    for (unsigned int i = 0; i < edges.size(); i++)
+        sorted.push_back(i);
+    std::sort(sorted.begin(), sorted.end(), startComparator(edges));
+
+    /// successors starts at end of edge, the edge back and zero length edges are skipped
+    nextStart.push_back(0);
+    for (unsigned int i = 0; i < edges.size(); i++)
+    {
+        int first = 0;
+        int last = sorted.size();
+        while (first < last)
+        {
+            int middle = (first + last) / 2;
+            const glm::vec3& v = edges[sorted[middle]].a;
+            const glm::vec3& e = edges[i].b;
+            if ((v.x < e.x) || ((v.x == e.x) && ((v.y < e.y) || ((v.y == e.y) && (v.z < e.z)))))
+                first = middle + 1;
+            else
+                last = middle;
+        }
+        for (unsigned int j = first; j < sorted.size(); j++)
+        {
+            const edge& next = edges[sorted[j]];
+            if ((next.a.x != edges[i].b.x) || (next.a.y != edges[i].b.y) || (next.a.z != edges[i].b.z))
+                break;
+            if (!::isSame(next, edges[i]))
+                if ((next.a.x != next.b.x) || (next.a.z != next.b.z))
+                    nextList.push_back(sorted[j]);
+        }
+        nextStart.push_back(nextList.size());
+    }
+
+    /// get extremes of track
+    float minX = startX.empty() ? 0 : startX[0];
+    float minZ = startZ.empty() ? 0 : startZ[0];
+    float maxX = minX;
+    float maxZ = minZ;
+    for (unsigned int i = 0; i < startX.size(); i++)
+    {
+        minX = glm::min(minX, glm::min(startX[i], endX[i]));
+        minZ = glm::min(minZ, glm::min(startZ[i], endZ[i]));
+        maxX = glm::max(maxX, glm::max(startX[i], endX[i]));
+        maxZ = glm::max(maxZ, glm::max(startZ[i], endZ[i]));
+    }
+
+    /// create grid, every edge is stored in all cells its box overlaps
+    gridX = minX;
+    gridZ = minZ;
+    cellSize = glm::max((float)TRACK_CELL_SIZE, glm::max(maxX - minX, maxZ - minZ) / TRACK_CELL_LIMIT);
+    columns = (int)((maxX - minX) / cellSize) + 1;
+    rows = (int)((maxZ - minZ) / cellSize) + 1;
+    std::vector<std::vector<int> > cells(columns * rows);
+    for (unsigned int i = 0; i < startX.size(); i++)
+    {
+        int range[4];
+        getCells(glm::min(startX[i], endX[i]), glm::min(startZ[i], endZ[i]),
+                 glm::max(startX[i], endX[i]), glm::max(startZ[i], endZ[i]), range);
+        for (int z = range[1]; z <= range[3]; z++)
+            for (int x = range[0]; x <= range[2]; x++)
+                cells[z * columns + x].push_back(i);
+    }
+    cellStart.push_back(0);
+    for (unsigned int i = 0; i < cells.size(); i++)
+    {
+        cellList.insert(cellList.end(), cells[i].begin(), cells[i].end());
+        cellStart.push_back(cellList.size());
+    }
+
+    /// count distances along race path
+    this->finish = finish;
+    lapLength = 0;
+    distance.resize(edges.size(), -1);
+    int index = finish;
+    std::vector<int> path;
+    while ((index >= 0) && (index < (int)edges.size()) && (distance[index] < 0))
+    {
+        distance[index] = lapLength;
+        lapLength += length[index];
+        path.push_back(index);
+        index = getNext(index);
+    }
+
+    /// plan racing line
+    lineX = endX;
+    lineZ = endZ;
+    speed.resize(edges.size(), TRACK_SPEED_MAX);
+    planLine(path, (index == finish) && (path.size() > 2));
+}
+
+/**
+ * @brief getCells gets range of grid cells covering area
+ * @param minX is minimal x coordinate of area
+ * @param minZ is minimal z coordinate of area
+ * @param maxX is maximal x coordinate of area
+ * @param maxZ is maximal z coordinate of area
+ * @param range is output first column, first row, last column and last row
+ */
+void track::getCells(float minX, float minZ, float maxX, float maxZ, int* range) const
+{
+    range[0] = glm::clamp((int)floor((minX - gridX) / cellSize), 0, columns - 1);
+    range[1] = glm::clamp((int)floor((minZ - gridZ) / cellSize), 0, rows - 1);
+    range[2] = glm::clamp((int)floor((maxX - gridX) / cellSize), 0, columns - 1);
+    range[3] = glm::clamp((int)floor((maxZ - gridZ) / cellSize), 0, rows - 1);
+}
+
+/**
+ * @brief getEdges finds edges in radius, it uses grid of edges
+ * @param pos is center of search
+ * @param radius is maximal distance of edge from center
+ * @param output is list to fill with indices of found edges
+ */
+void track::getEdges(glm::vec3 pos, float radius, std::vector<int>& output) const
+{
+    output.clear();
+    int range[4];
+    getCells(pos.x - radius, pos.z - radius, pos.x + radius, pos.z + radius, range);
+    for (int z = range[1]; z <= range[3]; z++)
+        for (int x = range[0]; x <= range[2]; x++)
+            for (int i = cellStart[z * columns + x]; i < cellStart[z * columns + x + 1]; i++)
+                if (getSegmentDistance(cellList[i], pos) <= radius)
+                    output.push_back(cellList[i]);
+
+    /// edges crossing more cells are found more times
+    std::sort(output.begin(), output.end());
+    output.erase(std::unique(output.begin(), output.end()), output.end());
+}
+
+/**
+ * @brief getNearest finds the nearest edge in radius, it uses grid of edges
+ * @param pos is center of search
+ * @param radius is maximal distance of edge from center
+ * @param racePath is true to find only edges on race path
+ * @return index of edge or -1 if there is no edge in radius
+ */
+int track::getNearest(glm::vec3 pos, float radius, bool racePath) const
+{
+    int nearest = -1;
+    float nearestDistance = radius;
+    int range[4];
+    getCells(pos.x - radius, pos.z - radius, pos.x + radius, pos.z + radius, range);
+    for (int z = range[1]; z <= range[3]; z++)
+        for (int x = range[0]; x <= range[2]; x++)
+            for (int i = cellStart[z * columns + x]; i < cellStart[z * columns + x + 1]; i++)
+            {
+                int index = cellList[i];
+                if (racePath && (distance[index] < 0))
+                    continue;
+                float d = getSegmentDistance(index, pos);
+                if ((d < nearestDistance) || ((d == nearestDistance) && (nearest < 0)))
+                {
+                    nearest = index;
+                    nearestDistance = d;
+                }
+            }
+    return nearest;
+}
+
+/**
+ * @brief getSegmentDistance gets distance of point from edge
+ * @param index is index of edge
+ * @param pos is point
+ * @return distance from the closest point of edge
+ */
+float track::getSegmentDistance(int index, glm::vec3 pos) const
+{
+    glm::vec3 a = getStart(index);
+    glm::vec3 b = getEnd(index);
+    float t = 0;
+    if (length[index] > 0)
+        t = glm::clamp(glm::dot(pos - a, b - a) / (length[index] * length[index]), 0.0f, 1.0f);
+    return glm::length(a + (b - a) * t - pos);
+}
+
+/**
+ * @brief planLine smooths race path into racing line and counts speeds from its curvature
+ * @param path is list of edges of race path in order of driving
+ * @param loop is true if race path is closed
+ */
+void track::planLine(std::vector<int> path, bool loop)
+{
+    int count = path.size();
+    if (count < 3)
+        return;
+
+    /// smooth path, the line may leave centre of track only by limited offset
+    std::vector<float> x(count), z(count);
+    for (int i = 0; i < count; i++)
+    {
+        x[i] = endX[path[i]];
+        z[i] = endZ[path[i]];
+    }
+    for (int k = 0; k < TRACK_LINE_ITERATIONS; k++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (!loop && ((i == 0) || (i == count - 1)))
+                continue;
+            int prev = (i + count - 1) % count;
+            int next = (i + 1) % count;
+            float dx = 0.5f * (x[prev] + x[next]) - x[i];
+            float dz = 0.5f * (z[prev] + z[next]) - z[i];
+            x[i] += 0.5f * dx;
+            z[i] += 0.5f * dz;
+            float ox = x[i] - endX[path[i]];
+            float oz = z[i] - endZ[path[i]];
+            float offset = sqrt(ox * ox + oz * oz);
+            if (offset > TRACK_LINE_OFFSET)
+            {
+                x[i] = endX[path[i]] + ox * TRACK_LINE_OFFSET / offset;
+                z[i] = endZ[path[i]] + oz * TRACK_LINE_OFFSET / offset;
+            }
+        }
+    }
+
+    /// speed from curvature of circle going through points around
+    std::vector<float> v(count, TRACK_SPEED_MAX);
+    for (int i = 0; i < count; i++)
+    {
+        int prev = i;
+        int next = i;
+        float before = 0;
+        float after = 0;
+        while ((before < TRACK_CURVE_WINDOW) && (loop || (prev > 0)) && (before < lapLength))
+        {
+            before += length[path[prev]];
+            prev = (prev + count - 1) % count;
+        }
+        while ((after < TRACK_CURVE_WINDOW) && (loop || (next < count - 1)) && (after < lapLength))
+        {
+            next = (next + 1) % count;
+            after += length[path[next]];
+        }
+        float ax = x[prev] - x[i], az = z[prev] - z[i];
+        float bx = x[next] - x[i], bz = z[next] - z[i];
+        float cx = x[next] - x[prev], cz = z[next] - z[prev];
+        float chord = sqrt(ax * ax + az * az) * sqrt(bx * bx + bz * bz) * sqrt(cx * cx + cz * cz);
+        float curvature = chord > 0 ? 2 * fabs(ax * bz - az * bx) / chord : 0;
+        if (curvature > 0)
+            v[i] = glm::min((float)TRACK_SPEED_MAX, sqrtf(TRACK_GRIP / curvature));
+    }
+
+    /// slow down before curves, closed path needs two passes
+    for (int k = 0; k < (loop ? 2 : 1); k++)
+    {
+        for (int i = count - 2 + (loop ? 1 : 0); i >= 0; i--)
+        {
+            int next = (i + 1) % count;
+            float brake = sqrt(v[next] * v[next] + 2 * TRACK_BRAKING * length[path[next]]);
+            v[i] = glm::min(v[i], brake);
+        }
+    }
+
+    /// store line
+    for (int i = 0; i < count; i++)
+    {
+        lineX[path[i]] = x[i];
+        lineZ[path[i]] = z[i];
+        speed[path[i]] = v[i];
+    }
+}
+
+/**
+ * @brief isSame check if two edges are the same in any direction
+ * @param a is index of the first edge
+ * @param b is index of the second edge
+ * @return true if edges are same
+ */
+bool track::isSame(int a, int b) const
+{
+    if ((startX[a] == endX[b]) && (startZ[a] == endZ[b]))
+        if ((startX[b] == endX[a]) && (startZ[b] == endZ[a]))
+            return true;
+    if ((startX[a] == startX[b]) && (startZ[a] == startZ[b]))
+        if ((endX[b] == endX[a]) && (endZ[b] == endZ[a]))
+            return true;
+    return false;
+}
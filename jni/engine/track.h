@@ -0,0 +1,176 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       track.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Graph of track edges used for navigation of cars. It is built once on
+ *             loading and shared by all cars.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef TRACK_H
+#define TRACK_H
+
+#include <vector>
+#include "engine/math.h"
+
+#define TRACK_BRAKING 6
+#define TRACK_CELL_LIMIT 256
+#define TRACK_CELL_SIZE 32
+#define TRACK_CURVE_WINDOW 10
+#define TRACK_GRIP 9
+#define TRACK_LINE_ITERATIONS 30
+#define TRACK_LINE_OFFSET 3
+#define TRACK_SPEED_MAX 80
+
+/**
+ * @brief The track class, it is immutable after construction
+ */
+class track
+{
+public:
+
+    /**
+     * @brief track constructor builds graph, every edge is added in both directions
+     * @param edges is list of track edges, reversed edges get index edges.size() + i
+     * @param finish is index of finish edge
+     */
+    track(std::vector<edge> edges, int finish);
+
+    /**
+     * @brief getDistance gets distance of edge start from finish along race path
+     * @param index is index of edge
+     * @return distance or -1 if edge is not on race path
+     */
+    float getDistance(int index) const { return distance[index]; }
+
+    /**
+     * @brief getEdgeCount gets amount of edges
+     * @return amount of edges
+     */
+    int getEdgeCount() const { return length.size(); }
+
+    /**
+     * @brief getEdges finds edges in radius, it uses grid of edges
+     * @param pos is center of search
+     * @param radius is maximal distance of edge from center
+     * @param output is list to fill with indices of found edges
+     */
+    void getEdges(glm::vec3 pos, float radius, std::vector<int>& output) const;
+
+    /**
+     * @brief getEnd gets end point of edge
+     * @param index is index of edge
+     * @return end point
+     */
+    glm::vec3 getEnd(int index) const { return glm::vec3(endX[index], endY[index], endZ[index]); }
+
+    /**
+     * @brief getFinish gets finish edge
+     * @return index of finish edge
+     */
+    int getFinish() const { return finish; }
+
+    /**
+     * @brief getLapLength gets length of race path
+     * @return length of one lap
+     */
+    float getLapLength() const { return lapLength; }
+
+    /**
+     * @brief getLength gets length of edge
+     * @param index is index of edge
+     * @return length of edge
+     */
+    float getLength(int index) const { return length[index]; }
+
+    /**
+     * @brief getNext gets the first possible next edge
+     * @param index is index of current edge
+     * @return index of next edge or -1 if there is no next edge
+     */
+    int getNext(int index) const { return nextStart[index] < nextStart[index + 1] ? nextList[nextStart[index]] : -1; }
+
+    /**
+     * @brief getLine gets point of racing line at end of edge
+     * @param index is index of edge
+     * @return point of racing line, it is end of edge for edges out of race path
+     */
+    glm::vec3 getLine(int index) const { return glm::vec3(lineX[index], endY[index], lineZ[index]); }
+
+    /**
+     * @brief getNearest finds the nearest edge in radius, it uses grid of edges
+     * @param pos is center of search
+     * @param radius is maximal distance of edge from center
+     * @param racePath is true to find only edges on race path
+     * @return index of edge or -1 if there is no edge in radius
+     */
+    int getNearest(glm::vec3 pos, float radius, bool racePath) const;
+
+    /**
+     * @brief getSegmentDistance gets distance of point from edge
+     * @param index is index of edge
+     * @param pos is point
+     * @return distance from the closest point of edge
+     */
+    float getSegmentDistance(int index, glm::vec3 pos) const;
+
+    /**
+     * @brief getSpeed gets target speed on racing line at end of edge
+     * @param index is index of edge
+     * @return speed in meters per second
+     */
+    float getSpeed(int index) const { return speed[index]; }
+
+    /**
+     * @brief getStart gets start point of edge
+     * @param index is index of edge
+     * @return start point
+     */
+    glm::vec3 getStart(int index) const { return glm::vec3(startX[index], startY[index], startZ[index]); }
+
+    /**
+     * @brief isSame check if two edges are the same in any direction
+     * @param a is index of the first edge
+     * @param b is index of the second edge
+     * @return true if edges are same
+     */
+    bool isSame(int a, int b) const;
+
+private:
+
+    /**
+     * @brief getCells gets range of grid cells covering area
+     * @param minX is minimal x coordinate of area
+     * @param minZ is minimal z coordinate of area
+     * @param maxX is maximal x coordinate of area
+     * @param maxZ is maximal z coordinate of area
+     * @param range is output first column, first row, last column and last row
+     */
+    void getCells(float minX, float minZ, float maxX, float maxZ, int* range) const;
+
+    /**
+     * @brief planLine smooths race path into racing line and counts speeds from its curvature
+     * @param path is list of edges of race path in order of driving
+     * @param loop is true if race path is closed
+     */
+    void planLine(std::vector<int> path, bool loop);
+
+    std::vector<float> startX, startY, startZ;  ///< Start points of edges
+    std::vector<float> endX, endY, endZ;        ///< End points of edges
+    std::vector<float> length;                  ///< Lengths of edges
+    std::vector<float> distance;                ///< Distances of edge starts from finish
+    std::vector<float> lineX, lineZ;            ///< Racing line at ends of edges
+    std::vector<float> speed;                   ///< Target speeds at ends of edges
+    std::vector<int> nextStart;                 ///< Offsets of successors of every edge in nextList
+    std::vector<int> nextList;                  ///< Successors of all edges
+    std::vector<int> cellStart;                 ///< Offsets of edges of every grid cell in cellList
+    std::vector<int> cellList;                  ///< Edges of all grid cells
+    float cellSize;                             ///< Size of grid cell
+    float gridX, gridZ;                         ///< Grid origin
+    int columns, rows;                          ///< Grid dimensions
+    int finish;                                 ///< Index of finish edge
+    float lapLength;                            ///< Length of race path
+};
+
+#endif // TRACK_H
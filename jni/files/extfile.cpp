@@ -10,8 +10,6 @@
 
 #include "files/extfile.h"
 
-FILE* extf;
-
 extfile::extfile(std::string filename)
 {
   name = filename;
@@ -23,11 +21,6 @@ extfile::~extfile()
   fclose(f);
 }
 
-void extfile::accessStatic()
-{
-  extf = f;
-}
-
 /**
  * @brief exists detects if file exists
  * @param name is path to file
@@ -94,6 +87,17 @@ void extfile::getsEx(char* line)
   }
 }
 
+/**
+ * @brief read reads block of data
+ * @param data is output buffer
+ * @param size is maximal amount of bytes to read
+ * @return amount of read bytes, 0 or less at end of file
+ */
+int extfile::read(void* data, int size)
+{
+  return fread(data, 1, size, f);
+}
+
 /**
  * @brief path gets path of filename
  * @return path as string
@@ -124,8 +128,3 @@ int extfile::scandec()
     }
     return number;
 }
-
-void png_read_ext(png_structp png_ptr, png_bytep data, png_size_t length)
-{
-  fread(data, length, 1, extf);
-}
@@ -10,7 +10,6 @@
 #ifndef EXTFILE_H
 #define EXTFILE_H
 
-#include <png.h>
 #include <stdio.h>
 #include <string>
 #include "interfaces/file.h"
@@ -22,8 +21,6 @@ public:
 
     ~extfile();
 
-    void accessStatic();
-
     /**
      * @brief exists detects if file exists
      * @param name is path to file
@@ -45,6 +42,14 @@ public:
 
     bool isArchive() { return false; }
 
+    /**
+     * @brief read reads block of data
+     * @param data is output buffer
+     * @param size is maximal amount of bytes to read
+     * @return amount of read bytes, 0 or less at end of file
+     */
+    int read(void* data, int size);
+
     /**
      * @brief path gets path of filename
      * @return path as string
@@ -60,6 +65,4 @@ private:
     FILE* f;
 };
 
-void png_read_ext(png_structp png_ptr, png_bytep data, png_size_t length);
-
 #endif // EXTFILE_H
@@ -0,0 +1,334 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       pngdecoder.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Thread safe PNG decoding on a worker pool, pixel buffers are taken from
+ *             a pool and reused after texture upload.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <png.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine/io.h"
+#include "engine/profiler.h"
+#include "files/pngdecoder.h"
+
+#define PNG_MAX_CHUNK 16777216
+#define PNG_POOL_SIZE 8388608
+#define PNG_READ_BLOCK 65536
+
+int pngdecoder::threads = 0;
+pngWorker pngdecoder::workers[PNG_MAX_THREADS];
+pthread_mutex_t pngdecoder::batchMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t pngdecoder::poolMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t pngdecoder::workMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t pngdecoder::workStart = PTHREAD_COND_INITIALIZER;
+pthread_cond_t pngdecoder::workDone = PTHREAD_COND_INITIALIZER;
+int pngdecoder::generation = 0;
+int pngdecoder::pending = 0;
+std::map<int, std::vector<unsigned char*> > pngdecoder::pool;
+int pngdecoder::poolSize = 0;
+std::vector<file*>* pngdecoder::jobFiles = 0;
+std::vector<Texture>* pngdecoder::jobResults = 0;
+volatile int pngdecoder::nextJob = 0;
+
+/**
+ * @brief The PNG input struct is read context of one decoding
+ */
+struct pngInput
+{
+    unsigned char* data;    ///< Content of whole file
+    int size;               ///< Size of file
+    int position;           ///< Position of next read
+};
+
+/**
+ * @brief readInput reads data for libpng from memory of current decoding
+ * @param png_ptr is libpng instance
+ * @param data is output buffer
+ * @param length is amount of bytes to read
+ */
+void readInput(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+    pngInput* input = (pngInput*)png_get_io_ptr(png_ptr);
+    if (input->position + (int)length > input->size)
+        png_error(png_ptr, "Unexpected end of file");
+    memcpy(data, input->data + input->position, length);
+    input->position += length;
+}
+
+/**
+ * @brief allocate gets pixel buffer from pool
+ * @param size is size of buffer in bytes
+ * @return buffer, it has to be returned by release
+ */
+unsigned char* pngdecoder::allocate(int size)
+{
+    pthread_mutex_lock(&poolMutex);
+    std::map<int, std::vector<unsigned char*> >::iterator it = pool.find(size);
+    if ((it != pool.end()) && !it->second.empty())
+    {
+        unsigned char* data = it->second.back();
+        it->second.pop_back();
+        poolSize -= size;
+        pthread_mutex_unlock(&poolMutex);
+        return data;
+    }
+    pthread_mutex_unlock(&poolMutex);
+    return new unsigned char[size];
+}
+
+/**
+ * @brief decode decodes one PNG file on calling thread, it can be called from
+ * any thread and decodes from several threads run concurrently
+ * @param f is file to decode, it is deleted
+ * @return texture raster instance
+ */
+Texture pngdecoder::decode(file* f)
+{
+    /// single file is decoded by caller with its own scratch buffers, no lock is needed
+    pngWorker scratch;
+    return decodeFile(f, &scratch);
+}
+
+/**
+ * @brief decode decodes PNG files in parallel, it can be called from any thread
+ * @param files is files to decode, they are deleted
+ * @return texture rasters in the same order as files
+ */
+std::vector<Texture> pngdecoder::decode(std::vector<file*> files)
+{
+    std::vector<Texture> results;
+    if (files.size() == 1)
+    {
+        results.push_back(decode(files[0]));
+        return results;
+    }
+
+    /// wake up workers and help them, only one batch is submitted at time
+    results.resize(files.size());
+    pthread_mutex_lock(&batchMutex);
+    jobFiles = &files;
+    jobResults = &results;
+    nextJob = 0;
+    startWorkers();
+    pthread_mutex_lock(&workMutex);
+    pending = threads - 1;
+    generation++;
+    pthread_cond_broadcast(&workStart);
+    pthread_mutex_unlock(&workMutex);
+    decodeJobs(&workers[0]);
+
+    /// wait until all files are decoded
+    pthread_mutex_lock(&workMutex);
+    while (pending > 0)
+        pthread_cond_wait(&workDone, &workMutex);
+    pthread_mutex_unlock(&workMutex);
+    pthread_mutex_unlock(&batchMutex);
+    return results;
+}
+
+/**
+ * @brief readHeader reads size and transparency of PNG file without decoding pixels
+ * @param f is file to read, it is deleted
+ * @return texture raster instance without pixel data
+ */
+Texture pngdecoder::readHeader(file* f)
+{
+    Texture texture;
+    texture.width = 1;
+    texture.height = 1;
+    texture.hasAlpha = false;
+    texture.data = 0;
+
+    /// chunks are read until image data, alpha is detected the same way as decode gets it
+    std::vector<unsigned char> chunk;
+    unsigned char head[8];
+    int colorType = -1;
+    bool valid = (f->read(head, 8) == 8) && (png_sig_cmp(head, 0, 8) == 0);
+    while (valid && (f->read(head, 8) == 8))
+    {
+        unsigned int length = (head[0] << 24) | (head[1] << 16) | (head[2] << 8) | head[3];
+        if ((memcmp(head + 4, "IDAT", 4) == 0) || (length > PNG_MAX_CHUNK))
+            break;
+        chunk.resize(length + 4);
+        if (f->read(&chunk[0], length + 4) != (int)length + 4)
+            break;
+        if ((memcmp(head + 4, "IHDR", 4) == 0) && (length >= 10))
+        {
+            texture.width = (chunk[0] << 24) | (chunk[1] << 16) | (chunk[2] << 8) | chunk[3];
+            texture.height = (chunk[4] << 24) | (chunk[5] << 16) | (chunk[6] << 8) | chunk[7];
+            colorType = chunk[9];
+            texture.hasAlpha = (colorType == PNG_COLOR_TYPE_GRAY_ALPHA) || (colorType == PNG_COLOR_TYPE_RGB_ALPHA);
+        } else if ((memcmp(head + 4, "tRNS", 4) == 0) && (colorType == PNG_COLOR_TYPE_PALETTE))
+            texture.hasAlpha = true;
+    }
+    if (colorType < 0)
+        loge("Unable to read PNG header in", f->path());
+    delete f;
+    return texture;
+}
+
+/**
+ * @brief release returns pixel buffer into pool
+ * @param data is buffer from allocate
+ * @param size is size of buffer in bytes
+ */
+void pngdecoder::release(unsigned char* data, int size)
+{
+    if (!data)
+        return;
+    pthread_mutex_lock(&poolMutex);
+    if (poolSize + size <= PNG_POOL_SIZE)
+    {
+        pool[size].push_back(data);
+        poolSize += size;
+        data = 0;
+    }
+    pthread_mutex_unlock(&poolMutex);
+    if (data)
+        delete[] data;
+}
+
+/**
+ * @brief release returns pixel buffer of raster into pool
+ * @param raster is texture raster instance
+ */
+void pngdecoder::release(Texture raster)
+{
+    release(raster.data, raster.width * raster.height * (raster.hasAlpha ? 4 : 3));
+}
+
+/**
+ * @brief decodeJobs takes files of current batch until there is none left
+ * @param worker is worker with scratch buffers
+ */
+void pngdecoder::decodeJobs(pngWorker* worker)
+{
+    while (true)
+    {
+        int job = __sync_fetch_and_add(&nextJob, 1);
+        if (job >= (int)jobFiles->size())
+            return;
+        (*jobResults)[job] = decodeFile((*jobFiles)[job], worker);
+    }
+}
+
+/**
+ * @brief decodeFile reads whole file and decodes it
+ * @param f is file to decode
+ * @param worker is worker with scratch buffers
+ * @return texture raster instance
+ */
+Texture pngdecoder::decodeFile(file* f, pngWorker* worker)
+{
+    PROFILE("pngdecoder::decode");
+
+    /// read whole file by blocks, buffer of worker is reused
+    std::vector<unsigned char>& buffer = worker->input;
+    int size = 0;
+    while (true)
+    {
+        if ((int)buffer.size() < size + PNG_READ_BLOCK)
+            buffer.resize(size + PNG_READ_BLOCK);
+        int count = f->read(&buffer[size], PNG_READ_BLOCK);
+        if (count <= 0)
+            break;
+        size += count;
+    }
+    std::string path = f->path();
+    delete f;
+
+    /// init PNG library, it reads from memory of this decoding only
+    Texture texture;
+    unsigned char* volatile data = 0;
+    pngInput input = {&buffer[0], size, 0};
+    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (setjmp(png_jmpbuf(png_ptr)))
+    {
+        /// broken file is replaced by white pixel
+        loge("Unable to decode PNG in", path);
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        if (data)
+            delete[] data;
+        texture.width = 1;
+        texture.height = 1;
+        texture.hasAlpha = false;
+        texture.data = allocate(3);
+        memset(texture.data, 255, 3);
+        return texture;
+    }
+    png_set_read_fn(png_ptr, &input, readInput);
+    png_read_info(png_ptr, info_ptr);
+
+    /// all images are converted into 8 bit RGB or RGBA
+    int color_type = png_get_color_type(png_ptr, info_ptr);
+    png_set_strip_16(png_ptr);
+    png_set_packing(png_ptr);
+    if (color_type == PNG_COLOR_TYPE_PALETTE)
+        png_set_palette_to_rgb(png_ptr);
+    if ((color_type == PNG_COLOR_TYPE_GRAY) || (color_type == PNG_COLOR_TYPE_GRAY_ALPHA))
+        png_set_gray_to_rgb(png_ptr);
+    png_set_interlace_handling(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+    texture.width = png_get_image_width(png_ptr, info_ptr);
+    texture.height = png_get_image_height(png_ptr, info_ptr);
+    texture.hasAlpha = png_get_channels(png_ptr, info_ptr) == 4;
+
+    /// rows are decoded directly into pooled buffer, bottom row first
+    unsigned int row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+    data = allocate(row_bytes * texture.height);
+    worker->rows.resize(texture.height);
+    for (int i = 0; i < texture.height; i++)
+        worker->rows[i] = data + row_bytes * (texture.height - 1 - i);
+    png_read_image(png_ptr, &worker->rows[0]);
+    png_read_end(png_ptr, NULL);
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    texture.data = data;
+    return texture;
+}
+
+/**
+ * @brief startWorkers creates worker threads if they do not exist, workers stay
+ * sleeping until the end of process
+ */
+void pngdecoder::startWorkers()
+{
+    if (threads > 0)
+        return;
+    threads = std::max(1, std::min((int)sysconf(_SC_NPROCESSORS_ONLN), PNG_MAX_THREADS));
+    for (int i = 0; i < PNG_MAX_THREADS; i++)
+        workers[i].generation = generation;
+    for (int i = 1; i < threads; i++)
+        pthread_create(&workers[i].thread, NULL, workerLoop, &workers[i]);
+}
+
+/**
+ * @brief workerLoop is cycle of worker thread
+ * @param ptr is pngWorker instance
+ * @return 0
+ */
+void* pngdecoder::workerLoop(void* ptr)
+{
+    pngWorker* worker = (pngWorker*)ptr;
+    pthread_mutex_lock(&workMutex);
+    while (true)
+    {
+        while (worker->generation == generation)
+            pthread_cond_wait(&workStart, &workMutex);
+        worker->generation = generation;
+        pthread_mutex_unlock(&workMutex);
+
+        decodeJobs(worker);
+
+        pthread_mutex_lock(&workMutex);
+        pending--;
+        if (pending == 0)
+            pthread_cond_signal(&workDone);
+    }
+    return 0;
+}
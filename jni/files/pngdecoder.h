@@ -0,0 +1,133 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       pngdecoder.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Thread safe PNG decoding on a worker pool, pixel buffers are taken from
+ *             a pool and reused after texture upload.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef PNGDECODER_H
+#define PNGDECODER_H
+
+#include <map>
+#include <pthread.h>
+#include <vector>
+#include "interfaces/file.h"
+
+#define PNG_MAX_THREADS 4
+
+struct Texture
+{
+    int width;
+    int height;
+    unsigned char* data;
+    bool hasAlpha;
+};
+
+/**
+ * @brief The decoding worker struct
+ */
+struct pngWorker
+{
+    int generation;                     ///< Last batch processed by worker
+    pthread_t thread;                   ///< Worker thread
+    std::vector<unsigned char> input;   ///< Reused buffer of compressed file
+    std::vector<unsigned char*> rows;   ///< Reused row pointers of decoded image
+};
+
+/**
+ * @brief The PNG decoder class
+ */
+class pngdecoder
+{
+public:
+
+    /**
+     * @brief allocate gets pixel buffer from pool
+     * @param size is size of buffer in bytes
+     * @return buffer, it has to be returned by release
+     */
+    static unsigned char* allocate(int size);
+
+    /**
+     * @brief decode decodes one PNG file on calling thread, it can be called from
+     * any thread and decodes from several threads run concurrently
+     * @param f is file to decode, it is deleted
+     * @return texture raster instance
+     */
+    static Texture decode(file* f);
+
+    /**
+     * @brief decode decodes PNG files in parallel, it can be called from any thread
+     * @param files is files to decode, they are deleted
+     * @return texture rasters in the same order as files
+     */
+    static std::vector<Texture> decode(std::vector<file*> files);
+
+    /**
+     * @brief readHeader reads size and transparency of PNG file without decoding pixels
+     * @param f is file to read, it is deleted
+     * @return texture raster instance without pixel data
+     */
+    static Texture readHeader(file* f);
+
+    /**
+     * @brief release returns pixel buffer into pool
+     * @param data is buffer from allocate
+     * @param size is size of buffer in bytes
+     */
+    static void release(unsigned char* data, int size);
+
+    /**
+     * @brief release returns pixel buffer of raster into pool
+     * @param raster is texture raster instance
+     */
+    static void release(Texture raster);
+
+private:
+
+    /**
+     * @brief decodeJobs takes files of current batch until there is none left
+     * @param worker is worker with scratch buffers
+     */
+    static void decodeJobs(pngWorker* worker);
+
+    /**
+     * @brief decodeFile reads whole file and decodes it
+     * @param f is file to decode
+     * @param worker is worker with scratch buffers
+     * @return texture raster instance
+     */
+    static Texture decodeFile(file* f, pngWorker* worker);
+
+    /**
+     * @brief startWorkers creates worker threads if they do not exist
+     */
+    static void startWorkers();
+
+    /**
+     * @brief workerLoop is cycle of worker thread
+     * @param ptr is pngWorker instance
+     * @return 0
+     */
+    static void* workerLoop(void* ptr);
+
+    static int threads;                                     ///< Amount of decoding threads
+    static pngWorker workers[PNG_MAX_THREADS];              ///< Workers (index 0 is batch caller)
+    static pthread_mutex_t batchMutex;                      ///< Lock for one batch at time
+    static pthread_mutex_t poolMutex;                       ///< Lock of pixel buffer pool
+    static pthread_mutex_t workMutex;                       ///< Lock for worker signalling
+    static pthread_cond_t workStart;                        ///< Signal for new batch
+    static pthread_cond_t workDone;                         ///< Signal for finished batch
+    static int generation;                                  ///< Batch counter for workers
+    static int pending;                                     ///< Amount of busy workers
+    static std::map<int, std::vector<unsigned char*> > pool;///< Free buffers by size
+    static int poolSize;                                    ///< Bytes of free buffers
+    static std::vector<file*>* jobFiles;                    ///< Files of current batch
+    static std::vector<Texture>* jobResults;                ///< Rasters of current batch
+    static volatile int nextJob;                            ///< Next file to take
+};
+
+#endif // PNGDECODER_H
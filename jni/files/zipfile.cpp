@@ -7,26 +7,26 @@
 **/
 ///----------------------------------------------------------------------------------------
 
+#include <pthread.h>
 #include "engine/io.h"
 #include "files/zipfile.h"
 
-zip_file* zipf = 0;
+pthread_mutex_t archiveMutex = PTHREAD_MUTEX_INITIALIZER; ///< Lock of shared archive, libzip is not thread safe
 
 zipfile::zipfile(std::string filename, zip* archive)
 {
   filename = fixName(filename);
   name = filename;
+  pthread_mutex_lock(&archiveMutex);
   f = zip_fopen(archive, filename.c_str(), 0);
+  pthread_mutex_unlock(&archiveMutex);
 }
 
 zipfile::~zipfile()
 {
+  pthread_mutex_lock(&archiveMutex);
   zip_fclose(f);
-}
-
-void zipfile::accessStatic()
-{
-  zipf = f;
+  pthread_mutex_unlock(&archiveMutex);
 }
 
 /**
@@ -39,12 +39,12 @@ bool zipfile::exists(const std::string& name, zip* archive)
 {
     if (!archive)
         return false;
-    if (zip_file *file = zip_fopen(archive, name.c_str(), 0))
-    {
+    pthread_mutex_lock(&archiveMutex);
+    zip_file *file = zip_fopen(archive, name.c_str(), 0);
+    if (file)
         zip_fclose(file);
-        return true;
-    } else
-        return false;
+    pthread_mutex_unlock(&archiveMutex);
+    return file != 0;
 }
 
 /**
@@ -54,6 +54,7 @@ bool zipfile::exists(const std::string& name, zip* archive)
 void zipfile::gets(char* line)
 {
   char character[2];
+  pthread_mutex_lock(&archiveMutex);
   for (int i = 0; i < 1020; i++)
   {
     zip_fread(f, character, 1);
@@ -62,9 +63,11 @@ void zipfile::gets(char* line)
     {
       line[i] = '\n';
       line[i + 1] = '\000';
+      pthread_mutex_unlock(&archiveMutex);
       return;
     }
   }
+  pthread_mutex_unlock(&archiveMutex);
   int i = 1020;
   line[i] = '\n';
   line[i + 1] = '\000';
@@ -78,6 +81,7 @@ void zipfile::getsEx(char* line)
 {
   line[1023] = '0';
   char character[2];
+  pthread_mutex_lock(&archiveMutex);
   for (int i = 0; i < 1020; i++)
   {
     int ok = zip_fread(f, character, 1);
@@ -86,15 +90,30 @@ void zipfile::getsEx(char* line)
       line[i + 1] = '\000';
       if (i == 0)
         line[1023] = '1';
-      return;
+      break;
     }
     line[i] = character[0];
     if (line[i] == '\n')
     {
       line[i + 1] = '\000';
-      return;
+      break;
     }
   }
+  pthread_mutex_unlock(&archiveMutex);
+}
+
+/**
+ * @brief read reads block of data
+ * @param data is output buffer
+ * @param size is maximal amount of bytes to read
+ * @return amount of read bytes, 0 or less at end of file
+ */
+int zipfile::read(void* data, int size)
+{
+  pthread_mutex_lock(&archiveMutex);
+  int count = zip_fread(f, data, size);
+  pthread_mutex_unlock(&archiveMutex);
+  return count;
 }
 
 /**
@@ -127,8 +146,3 @@ int zipfile::scandec()
     }
     return number;
 }
-
-void png_read_zip(png_structp png_ptr, png_bytep data, png_size_t length)
-{
-  zip_fread(zipf, data, length);
-}
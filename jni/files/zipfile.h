@@ -10,7 +10,6 @@
 #ifndef ZIPFILE_H
 #define ZIPFILE_H
 
-#include <png.h>
 #include <string>
 #include <zip.h>
 #include "interfaces/file.h"
@@ -22,8 +21,6 @@ public:
 
     ~zipfile();
 
-    void accessStatic();
-
     /**
      * @brief exists detects if file exists
      * @param name is path to file
@@ -46,6 +43,14 @@ public:
 
     bool isArchive() { return true; }
 
+    /**
+     * @brief read reads block of data
+     * @param data is output buffer
+     * @param size is maximal amount of bytes to read
+     * @return amount of read bytes, 0 or less at end of file
+     */
+    int read(void* data, int size);
+
     /**
      * @brief path gets path of filename
      * @return path as string
@@ -61,6 +66,4 @@ private:
     zip_file* f;
 };
 
-void png_read_zip(png_structp png_ptr, png_bytep data, png_size_t length);
-
 #endif // ZIPFILE_H
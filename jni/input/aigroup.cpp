@@ -0,0 +1,262 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       aigroup.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Decisions of all AI racers computed together in one loop over arrays of
+ *             car states with scalar math per car, optionally on a worker thread.
+**/
+///----------------------------------------------------------------------------------------
+
+#include "input/aigroup.h"
+
+#define LOOKAHEAD_DISTANCE 20
+#define LOOKAHEAD_SPEED_DEPENDENCY 0.5
+#define REVERSE_DELAY 50
+#define REVERSE_DURATION 30
+#define SPEED_BRAKE_TOLERANCE 1.1
+#define SPEED_KMH 3.6
+#define STEERING_GAP_LOW 5
+#define STEERING_GAP_HIGH 15
+#define TRACK_UPDATE 20
+#define TRACK_UPDATE_SPEED_DEPENDENCY 20
+
+/**
+ * @brief aigroup constructor
+ */
+aigroup::aigroup()
+{
+    edges = 0;
+    threaded = false;
+    ready = false;
+    busy = false;
+    quit = false;
+    pthread_mutex_init(&workMutex, NULL);
+    pthread_cond_init(&workStart, NULL);
+    pthread_cond_init(&workDone, NULL);
+}
+
+/**
+ * @brief aigroup destructor
+ */
+aigroup::~aigroup()
+{
+    setThreaded(false);
+    pthread_cond_destroy(&workDone);
+    pthread_cond_destroy(&workStart);
+    pthread_mutex_destroy(&workMutex);
+}
+
+/**
+ * @brief add adds car driven by AI
+ * @param c is instance of car
+ * @return slot of car in group
+ */
+int aigroup::add(car* c)
+{
+    wait();
+    ready = false;
+    edges = c->edges;
+    cars.push_back(c);
+    posX.push_back(0);
+    posZ.push_back(0);
+    rot.push_back(0);
+    speed.push_back(0);
+    currentEdge.push_back(0);
+    targetX.push_back(0);
+    targetZ.push_back(0);
+    limit.push_back(0);
+    problem.push_back(0);
+    reverseMode.push_back(false);
+    started.push_back(false);
+    nextBrake.push_back(0);
+    nextGas.push_back(0);
+    nextSteer.push_back(0);
+    nextLookahead.push_back(TRACK_UPDATE);
+    brake.push_back(0);
+    gas.push_back(0);
+    steer.push_back(0);
+    lookahead.push_back(TRACK_UPDATE);
+    return cars.size() - 1;
+}
+
+/**
+ * @brief prepare takes state of cars at end of tick, on worker thread decisions of
+ * next tick are computed while the rest of frame continues
+ */
+void aigroup::prepare()
+{
+    if (!threaded)
+        return;
+    wait();
+    gather();
+    pthread_mutex_lock(&workMutex);
+    busy = true;
+    pthread_cond_signal(&workStart);
+    pthread_mutex_unlock(&workMutex);
+}
+
+/**
+ * @brief setThreaded enables computing on worker thread
+ * @param on is true to use worker thread
+ */
+void aigroup::setThreaded(bool on)
+{
+    if (threaded == on)
+        return;
+    wait();
+    ready = false;
+    if (on)
+    {
+        quit = false;
+        pthread_create(&thread, NULL, workerLoop, this);
+    } else
+    {
+        pthread_mutex_lock(&workMutex);
+        quit = true;
+        pthread_cond_signal(&workStart);
+        pthread_mutex_unlock(&workMutex);
+        pthread_join(thread, NULL);
+    }
+    threaded = on;
+}
+
+/**
+ * @brief update publishes decisions of current tick, it is called before cars read them
+ */
+void aigroup::update()
+{
+    /// state of cars did not change since prepare, so the result is the same as serial one
+    wait();
+    if (!ready)
+    {
+        gather();
+        compute();
+    }
+    ready = false;
+    brake = nextBrake;
+    gas = nextGas;
+    steer = nextSteer;
+    lookahead = nextLookahead;
+}
+
+/**
+ * @brief compute counts decisions of all cars from taken state
+ */
+void aigroup::compute()
+{
+    /// cars stay standing on track without edges
+    int count = edges && (edges->getEdgeCount() > 0) ? cars.size() : 0;
+
+    /// look in front of cars, the slowest place of racing line is limiting speed
+    for (int i = 0; i < count; i++)
+    {
+        int ahead = currentEdge[i];
+        glm::vec3 target = edges->getLine(ahead);
+        targetX[i] = target.x;
+        targetZ[i] = target.z;
+        limit[i] = edges->getSpeed(ahead);
+        float length = LOOKAHEAD_DISTANCE + speed[i] * LOOKAHEAD_SPEED_DEPENDENCY;
+        float dst = distance(posX[i], posZ[i], edges->getEnd(ahead).x, edges->getEnd(ahead).z);
+        while (dst < length)
+        {
+            ahead = edges->getNext(ahead);
+            if (ahead < 0)
+                break;
+            limit[i] = fmin(limit[i], edges->getSpeed(ahead));
+            dst += edges->getLength(ahead);
+        }
+    }
+
+    /// steering and pedals, math is scalar per car and shared with other code by gap()
+    for (int i = 0; i < count; i++)
+    {
+        float g = gap(glm::vec3(targetX[i], 0, targetZ[i]), glm::vec3(posX[i], 0, posZ[i]), rot[i]);
+        float s = glm::clamp(-g / STEERING_GAP_HIGH, -1.0f, 1.0f);
+        nextSteer[i] = fabsf(g) < STEERING_GAP_LOW ? 0 : s;
+        float l = limit[i] * SPEED_KMH;
+        nextGas[i] = speed[i] < l ? 1 : 0;
+        nextBrake[i] = speed[i] > l * SPEED_BRAKE_TOLERANCE ? 0.5f : 0;
+        nextLookahead[i] = TRACK_UPDATE + speed[i] / TRACK_UPDATE_SPEED_DEPENDENCY;
+    }
+
+    /// detect stuck cars, waiting on start is not a problem
+    for (int i = 0; i < count; i++)
+    {
+        if ((int)speed[i] > 5)
+            started[i] = true;
+        if (((int)speed[i] > 5) && !reverseMode[i])
+            problem[i] = 0;
+        else if (started[i])
+            problem[i]++;
+        if (problem[i] >= REVERSE_DELAY)
+            reverseMode[i] = true;
+        if (problem[i] >= REVERSE_DELAY + REVERSE_DURATION)
+        {
+            reverseMode[i] = false;
+            problem[i] = 0;
+        }
+
+        /// reverse out of obstacle
+        if (reverseMode[i])
+        {
+            nextGas[i] = 0;
+            nextBrake[i] = 0.5f;
+            nextSteer[i] = 0;
+        }
+    }
+    ready = true;
+}
+
+/**
+ * @brief gather takes state of all cars into arrays
+ */
+void aigroup::gather()
+{
+    for (unsigned int i = 0; i < cars.size(); i++)
+    {
+        posX[i] = cars[i]->pos.x;
+        posZ[i] = cars[i]->pos.z;
+        rot[i] = cars[i]->rot;
+        speed[i] = cars[i]->speed;
+        currentEdge[i] = cars[i]->currentEdge;
+    }
+}
+
+/**
+ * @brief wait waits until worker thread finishes computing
+ */
+void aigroup::wait()
+{
+    pthread_mutex_lock(&workMutex);
+    while (busy)
+        pthread_cond_wait(&workDone, &workMutex);
+    pthread_mutex_unlock(&workMutex);
+}
+
+/**
+ * @brief workerLoop is cycle of worker thread
+ * @param ptr is aigroup instance
+ * @return 0
+ */
+void* aigroup::workerLoop(void* ptr)
+{
+    aigroup* g = (aigroup*)ptr;
+    pthread_mutex_lock(&g->workMutex);
+    while (true)
+    {
+        while (!g->quit && !g->busy)
+            pthread_cond_wait(&g->workStart, &g->workMutex);
+        if (g->quit)
+            break;
+        pthread_mutex_unlock(&g->workMutex);
+
+        g->compute();
+
+        pthread_mutex_lock(&g->workMutex);
+        g->busy = false;
+        pthread_cond_signal(&g->workDone);
+    }
+    pthread_mutex_unlock(&g->workMutex);
+    return 0;
+}
@@ -0,0 +1,137 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       aigroup.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Decisions of all AI racers computed together in one loop over arrays of
+ *             car states with scalar math per car, optionally on a worker thread.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef AIGROUP_H
+#define AIGROUP_H
+
+#include <pthread.h>
+#include <vector>
+#include "engine/car.h"
+
+/**
+ * @brief The AI group class
+ */
+class aigroup
+{
+public:
+
+    /**
+     * @brief aigroup constructor
+     */
+    aigroup();
+
+    /**
+     * @brief aigroup destructor
+     */
+    ~aigroup();
+
+    /**
+     * @brief add adds car driven by AI
+     * @param c is instance of car
+     * @return slot of car in group
+     */
+    int add(car* c);
+
+    /**
+     * @brief getBrake gets brake decision of car
+     * @param slot is slot of car
+     * @return value between 0 and 1
+     */
+    float getBrake(int slot) { return brake[slot]; }
+
+    /**
+     * @brief getGas gets gas decision of car
+     * @param slot is slot of car
+     * @return value between 0 and 1
+     */
+    float getGas(int slot) { return gas[slot]; }
+
+    /**
+     * @brief getSteer gets steering decision of car
+     * @param slot is slot of car
+     * @return value between -1 and 1
+     */
+    float getSteer(int slot) { return steer[slot]; }
+
+    /**
+     * @brief getUpdate gets distance of checkpoint for car
+     * @param slot is slot of car
+     * @return distance in meters
+     */
+    float getUpdate(int slot) { return lookahead[slot]; }
+
+    /**
+     * @brief prepare takes state of cars at end of tick, on worker thread decisions of
+     * next tick are computed while the rest of frame continues
+     */
+    void prepare();
+
+    /**
+     * @brief setThreaded enables computing on worker thread
+     * @param on is true to use worker thread
+     */
+    void setThreaded(bool on);
+
+    /**
+     * @brief update publishes decisions of current tick, it is called before cars read them
+     */
+    void update();
+
+private:
+
+    /**
+     * @brief compute counts decisions of all cars from taken state
+     */
+    void compute();
+
+    /**
+     * @brief gather takes state of all cars into arrays
+     */
+    void gather();
+
+    /**
+     * @brief wait waits until worker thread finishes computing
+     */
+    void wait();
+
+    /**
+     * @brief workerLoop is cycle of worker thread
+     * @param ptr is aigroup instance
+     * @return 0
+     */
+    static void* workerLoop(void* ptr);
+
+    std::vector<car*> cars;                     ///< Cars driven by AI
+    const track* edges;                         ///< Track graph
+    std::vector<float> posX, posZ;              ///< Taken positions
+    std::vector<float> rot;                     ///< Taken headings in degrees
+    std::vector<float> speed;                   ///< Taken speeds
+    std::vector<int> currentEdge;               ///< Taken current edges
+    std::vector<float> targetX, targetZ;        ///< Points of racing line to steer to
+    std::vector<float> limit;                   ///< Speed limits in front of cars
+    std::vector<int> problem;                   ///< Indicates bad situation state
+    std::vector<char> reverseMode;              ///< Indicates reverse mode
+    std::vector<char> started;                  ///< Indicates that car was already moving
+    std::vector<float> nextBrake, nextGas;      ///< Computed pedal decisions
+    std::vector<float> nextSteer, nextLookahead; ///< Computed steering decisions
+    std::vector<float> brake, gas;              ///< Published pedal decisions
+    std::vector<float> steer, lookahead;        ///< Published steering decisions
+
+    bool threaded;                              ///< Worker thread is used
+    bool ready;                                 ///< Decisions of next tick were computed
+    bool busy;                                  ///< Worker thread is computing
+    bool quit;                                  ///< Request to stop worker
+    pthread_t thread;                           ///< Worker thread
+    pthread_mutex_t workMutex;                  ///< Lock for worker signalling
+    pthread_cond_t workStart;                   ///< Signal for new tick
+    pthread_cond_t workDone;                    ///< Signal for computed tick
+};
+
+#endif // AIGROUP_H
@@ -7,26 +7,18 @@
 **/
 ///----------------------------------------------------------------------------------------
 
-#include "engine/math.h"
 #include "input/airacer.h"
 
 #define CAMERA_DISTANCE 2.0
-#define REVERSE_DELAY 50
-#define REVERSE_DURATION 30
-#define SAFE_GAP_GAS 15
-#define SAFE_SPEED 20
-#define STEERING_GAP_LOW 5
-#define STEERING_GAP_HIGH 15
-#define TRACK_UPDATE 20
-#define TRACK_UPDATE_SPEED_DEPENDENCY 20
 
 /**
  * @brief airacer Creates new control instance
+ * @param g is group computing decisions of all AI racers
  */
-airacer::airacer()
+airacer::airacer(aigroup* g)
 {
-    problem = 0;
-    reverseMode = false;
+    group = g;
+    slot = -1;
 }
 
 /**
@@ -35,7 +27,7 @@ airacer::airacer()
  */
 void airacer::init(car * c)
 {
-    vehicle = c;
+    slot = group->add(c);
 }
 
 /**
@@ -44,10 +36,7 @@ void airacer::init(car * c)
  */
 float airacer::getBrake()
 {
-    if (getGas() > 0.8f)
-         return 0;
-    else
-         return 0.5f;
+    return group->getBrake(slot);
 }
 
 /**
@@ -65,17 +54,7 @@ float airacer::getDistance()
  */
 float airacer::getGas()
 {
-    /// no gas on reverse mode
-    if (reverseMode)
-         return 0;
-
-    /// check angle of turn
-    if (vehicle->speed > SAFE_SPEED)
-        if (fabsf(gap(vehicle->currentEdge.b, vehicle->pos, vehicle->rot)) > SAFE_GAP_GAS)
-             return 0;
-    if ((int)vehicle->speed > 5)
-        problem = 0;
-     return 1;
+    return group->getGas(slot);
 }
 
 /**
@@ -93,23 +72,7 @@ bool airacer::getNitro()
  */
 float airacer::getSteer()
 {
-    /// no turning on reverse mode
-    if (reverseMode)
-         return 0;
-
-    /// count track direction
-    float g2 = gap(vehicle->currentEdge.b, vehicle->pos, vehicle->rot);
-
-    /// update direction
-    if (g2 > STEERING_GAP_HIGH)
-         return -1;
-    if (g2 < -STEERING_GAP_HIGH)
-         return 1;
-    if (g2 > STEERING_GAP_LOW)
-         return -0.5;
-    if (g2 < -STEERING_GAP_LOW)
-         return 0.5;
-     return 0;
+    return group->getSteer(slot);
 }
 
 /**
@@ -119,17 +82,5 @@ float airacer::getSteer()
  */
 float airacer::getUpdate()
 {
-    if ((this->getGas() > 0) & ((int)vehicle->speed <= 5))
-        problem++;
-    if (problem >= REVERSE_DELAY)
-    {
-        reverseMode = true;
-        problem++;
-    }
-    if (problem >= REVERSE_DELAY + REVERSE_DURATION)
-    {
-        reverseMode = false;
-        problem = 0;
-    }
-    return TRACK_UPDATE + vehicle->speed / TRACK_UPDATE_SPEED_DEPENDENCY;
+    return group->getUpdate(slot);
 }
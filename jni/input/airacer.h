@@ -11,6 +11,7 @@
 #define AIRACER_H
 
 #include "engine/car.h"
+#include "input/aigroup.h"
 #include "interfaces/input.h"
 
 /**
@@ -19,14 +20,14 @@
 class airacer : public input
 {
 public:
-    car* vehicle;       ///< Instance of car
-    int problem;        ///< Indicates bad situation state
-    bool reverseMode;   ///< Indicates reverse mode
+    aigroup* group;     ///< Group computing decisions
+    int slot;           ///< Slot of car in group
 
     /**
      * @brief airacer Creates new control instance
+     * @param g is group computing decisions of all AI racers
      */
-    airacer();
+    airacer(aigroup* g);
 
     /**
      * @brief init makes instance ready for use
@@ -76,6 +77,11 @@ public:
      * @return constant distance in float
      */
     float getUpdate();
+
+    /**
+     * @brief update does nothing, decisions of all AI racers are updated by group
+     */
+    void update() {}
 };
 
 #endif // AIRACER_H
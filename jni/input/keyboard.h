@@ -67,6 +67,11 @@ public:
      */
     float getUpdate();
 
+    /**
+     * @brief update is called once per simulation tick before the state is read
+     */
+    void update() {}
+
 
     /// Key pressed
     /**
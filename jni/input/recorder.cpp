@@ -0,0 +1,50 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       recorder.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Car control which records state of other control into file every tick
+**/
+///----------------------------------------------------------------------------------------
+
+#include "input/recorder.h"
+
+/**
+ * @brief recorder creates new control instance
+ * @param source is recorded control, it is destroyed with recorder
+ * @param output is opened file to write into
+ */
+recorder::recorder(input* source, FILE* output)
+{
+    this->source = source;
+    this->output = output;
+    frame.gas = 0;
+    frame.brake = 0;
+    frame.steer = 0;
+    frame.nitro = 0;
+}
+
+/**
+ * @brief recorder destructor
+ */
+recorder::~recorder()
+{
+    delete source;
+}
+
+/**
+ * @brief update reads state of recorded control and writes it into file
+ */
+void recorder::update()
+{
+    /// quantize state, the game uses the quantized values too to keep replay identical
+    source->update();
+    float gas = source->getGas();
+    float brake = source->getBrake();
+    float steer = source->getSteer();
+    frame.gas = (unsigned char)(gas < 0 ? 0 : gas > 1 ? 255 : gas * 255 + 0.5f);
+    frame.brake = (unsigned char)(brake < 0 ? 0 : brake > 1 ? 255 : brake * 255 + 0.5f);
+    frame.steer = (signed char)(steer < -1 ? -127 : steer > 1 ? 127 : steer * 127 + (steer < 0 ? -0.5f : 0.5f));
+    frame.nitro = source->getNitro() ? 1 : 0;
+    fwrite(&frame, sizeof(inputFrame), 1, output);
+}
@@ -0,0 +1,97 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       recorder.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Car control which records state of other control into file every tick
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdio.h>
+#include "interfaces/input.h"
+
+#define INPUT_FILE_MAGIC "O4SI"
+#define INPUT_FILE_VERSION 1
+
+/**
+ * @brief The input frame struct is state of one car in one tick
+ */
+struct inputFrame
+{
+    unsigned char gas;      ///< Gas from 0 to 255
+    unsigned char brake;    ///< Brake from 0 to 255
+    signed char steer;      ///< Steering from -127 to 127
+    unsigned char nitro;    ///< Nitro 0 or 1
+};
+
+/**
+ * @brief The recorder class
+ */
+class recorder : public input
+{
+public:
+
+    /**
+     * @brief recorder creates new control instance
+     * @param source is recorded control, it is destroyed with recorder
+     * @param output is opened file to write into
+     */
+    recorder(input* source, FILE* output);
+
+    /**
+     * @brief recorder destructor
+     */
+    ~recorder();
+
+    /**
+     * @brief getBrake Get brakes state
+     * @return value between 0 and 1 where 0=not braking and 1=braking
+     */
+    float getBrake() { return frame.brake / 255.0f; }
+
+    /**
+     * @brief getDistance Get distance of camera from car for camera transformation
+     * @return distance in float
+     */
+    float getDistance() { return source->getDistance(); }
+
+    /**
+     * @brief getGas Get gas pedal state
+     * @return value between 0 and 1 where 0=unpressed and 1=full pressed
+     */
+    float getGas() { return frame.gas / 255.0f; }
+
+    /**
+     * @brief getNitro get nitro power
+     * @return 0 if nitro is disable and 1 if it is enabled
+     */
+    bool getNitro() { return frame.nitro != 0; }
+
+    /**
+     * @brief getSteer Get current volant state
+     * @return value between -1 and 1 where -1=left, 0=center and 1=right
+     */
+    float getSteer() { return frame.steer / 127.0f; }
+
+    /**
+     * @brief getUpdate Get minimal distance from car to next checkpoint, this value may be bigger
+      for faster cars
+     * @return constant distance in float
+     */
+    float getUpdate() { return source->getUpdate(); }
+
+    /**
+     * @brief update reads state of recorded control and writes it into file
+     */
+    void update();
+
+private:
+    input* source;      ///< Recorded control
+    FILE* output;       ///< Output file
+    inputFrame frame;   ///< State of current tick
+};
+
+#endif // RECORDER_H
@@ -0,0 +1,50 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       replay.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Car control which plays state recorded by recorder
+**/
+///----------------------------------------------------------------------------------------
+
+#include "input/replay.h"
+
+/**
+ * @brief replay creates new control instance
+ * @param source is original control used for camera and navigation, it is destroyed with replay
+ * @param record is opened file to read from
+ */
+replay::replay(input* source, FILE* record)
+{
+    this->source = source;
+    this->record = record;
+    finished = false;
+    frame.gas = 0;
+    frame.brake = 0;
+    frame.steer = 0;
+    frame.nitro = 0;
+}
+
+/**
+ * @brief replay destructor
+ */
+replay::~replay()
+{
+    delete source;
+}
+
+/**
+ * @brief update reads state of next tick from file
+ */
+void replay::update()
+{
+    source->update();
+    if (finished || (fread(&frame, sizeof(inputFrame), 1, record) != 1))
+    {
+        finished = true;
+        frame.gas = 0;
+        frame.brake = 0;
+        frame.steer = 0;
+        frame.nitro = 0;
+    }
+}
@@ -0,0 +1,83 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       replay.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Car control which plays state recorded by recorder
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "input/recorder.h"
+
+/**
+ * @brief The replay class
+ */
+class replay : public input
+{
+public:
+    bool finished;      ///< Information if the record has no more data
+
+    /**
+     * @brief replay creates new control instance
+     * @param source is original control used for camera and navigation, it is destroyed with replay
+     * @param record is opened file to read from
+     */
+    replay(input* source, FILE* record);
+
+    /**
+     * @brief replay destructor
+     */
+    ~replay();
+
+    /**
+     * @brief getBrake Get brakes state
+     * @return value between 0 and 1 where 0=not braking and 1=braking
+     */
+    float getBrake() { return frame.brake / 255.0f; }
+
+    /**
+     * @brief getDistance Get distance of camera from car for camera transformation
+     * @return distance in float
+     */
+    float getDistance() { return source->getDistance(); }
+
+    /**
+     * @brief getGas Get gas pedal state
+     * @return value between 0 and 1 where 0=unpressed and 1=full pressed
+     */
+    float getGas() { return frame.gas / 255.0f; }
+
+    /**
+     * @brief getNitro get nitro power
+     * @return 0 if nitro is disable and 1 if it is enabled
+     */
+    bool getNitro() { return frame.nitro != 0; }
+
+    /**
+     * @brief getSteer Get current volant state
+     * @return value between -1 and 1 where -1=left, 0=center and 1=right
+     */
+    float getSteer() { return frame.steer / 127.0f; }
+
+    /**
+     * @brief getUpdate Get minimal distance from car to next checkpoint, this value may be bigger
+      for faster cars
+     * @return constant distance in float
+     */
+    float getUpdate() { return source->getUpdate(); }
+
+    /**
+     * @brief update reads state of next tick from file
+     */
+    void update();
+
+private:
+    input* source;      ///< Original control
+    FILE* record;       ///< Input file
+    inputFrame frame;   ///< State of current tick
+};
+
+#endif // REPLAY_H
@@ -20,8 +20,6 @@ public:
 
     virtual ~file() {}
 
-    virtual void accessStatic() = 0;
-
     /**
      * @brief gets custom implementation of syntax fgets
      * @param line is data to read
@@ -36,6 +34,14 @@ public:
 
     virtual bool isArchive() = 0;
 
+    /**
+     * @brief read reads block of data
+     * @param data is output buffer
+     * @param size is maximal amount of bytes to read
+     * @return amount of read bytes, 0 or less at end of file
+     */
+    virtual int read(void* data, int size) = 0;
+
     /**
      * @brief path gets path of file
      * @return path as string
@@ -57,6 +57,11 @@ public:
      * @return constant distance in float
      */
     virtual float getUpdate() = 0;
+
+    /**
+     * @brief update is called once per simulation tick before the state is read
+     */
+    virtual void update() = 0;
 };
 
 #endif // INPUT_H
@@ -17,6 +17,11 @@
 class materialLoader
 {
 public:
+    /**
+     * @brief ~materialLoader is destructor
+     */
+    virtual ~materialLoader() {}
+
     /**
      * @brief getShader compile shader from file
      * @param name is shader filename
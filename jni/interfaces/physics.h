@@ -40,14 +40,6 @@ public:
      */
     virtual void addModel(model *m, id3d id) = 0;
 
-    /**
-     * @brief getTransform counts OpenGL matrix of transformation
-     * @param index is index of object
-     * @param m is float[16] for output
-     * @param id is 3d position index
-     */
-    virtual void getTransform(int index, float* m, id3d id) = 0;
-
     /**
      * @brief removeModel removes model from physical engine
      * @param id is 3d position index
@@ -60,6 +52,25 @@ public:
      */
     virtual void resetCar(car* c, bool total = true) = 0;
 
+    /**
+     * @brief setCarKinematic switches car between simulation and kinematic movement
+     * @param c is instance of car
+     * @param kinematic is true to take car out of simulation
+     */
+    virtual void setCarKinematic(car* c, bool kinematic) = 0;
+
+    /**
+     * @brief setDeterministic sets simulation into reproducible mode
+     * @param on is true to get the same result from the same inputs
+     */
+    virtual void setDeterministic(bool on) = 0;
+
+    /**
+     * @brief setThreads sets amount of threads for solving simulation islands
+     * @param count is amount of threads, 1 for serial simulation
+     */
+    virtual void setThreads(int count) = 0;
+
     /**
      * @brief updateCar updates car state
      * @param c is instance of car
@@ -12,17 +12,34 @@
 
 #include "engine/matrices.h"
 #include "engine/model.h"
+#include "engine/renderstate.h"
 #include "interfaces/shader.h"
 #include "interfaces/texture.h"
 
+#define PARTICLE_BATCH 64
+
+/**
+ * @brief frameLog is summary of one rendered frame
+ */
+struct frameLog
+{
+    int drawCalls;      ///< Amount of draw calls
+    int triangles;      ///< Amount of drawn triangles
+    int bytes;          ///< Amount of vertex data sent to GPU
+    int shaderBinds;    ///< Amount of shader changes
+    int textureBinds;   ///< Amount of texture changes
+    int stateChanges;   ///< Amount of other render state changes
+};
+
 /**
  * @brief The renderer interface
  */
-class renderer : public matrices
+class renderer : public matrices, public renderstate
 {
 public:
 
     float aliasing;      ///< Screen detail
+    int animationFrame;  ///< Frame of animated textures in next draw calls
     bool enable[10];     ///< Enabled filter
     int width;           ///< Screen width
     int height;          ///< Screen height
@@ -32,6 +49,33 @@ public:
      */
     virtual ~renderer() {}
 
+    /**
+     * @brief adaptResolution changes render scale by measured frame time
+     * @param frameTime is measured GPU time of frame in milliseconds
+     */
+    virtual void adaptResolution(float /*frameTime*/) {}
+
+    /**
+     * @brief createShader creates shader for this renderer
+     * @param vert is vertex shader code
+     * @param frag is fragment shader code
+     * @return shader instance
+     */
+    virtual shader* createShader(std::vector<std::string> vert, std::vector<std::string> frag) = 0;
+
+    /**
+     * @brief createTexture creates texture for this renderer
+     * @param raster is texture raster instance, it is released
+     * @return texture instance
+     */
+    virtual texture* createTexture(Texture raster) = 0;
+
+    /**
+     * @brief getFrameLog gets summary of last finished frame
+     * @return frame summary, it is empty if renderer does not count frames
+     */
+    virtual frameLog getFrameLog() { return frameLog(); }
+
     /**
      * @brief init inits renderer
      * @param w is screen width
@@ -55,12 +99,31 @@ public:
      */
     virtual void renderModel(model* m) = 0;
 
+    /**
+     * @brief renderParticles renders billboard for every particle
+     * @param x is array of particle x coordinates
+     * @param y is array of particle y coordinates
+     * @param z is array of particle z coordinates
+     * @param count is amount of particles
+     * @param sh is shader which places billboard by particle index
+     * @param billboard is model of one billboard with texture
+     */
+    virtual void renderParticles(float* x, float* y, float* z, int count, shader* sh, model3d* billboard) = 0;
+
     /**
      * @brief renderShadow renders shadow of model into scene
      * @param m is instance of model to render
      */
     virtual void renderShadow(model* m) = 0;
 
+    /**
+     * @brief renderShadows renders blob shadows under all cars in one pass
+     * @param vertices is vertices of blobs in world space
+     * @param coords is texture coords of blobs
+     * @param triangleCount is triangle count
+     */
+    virtual void renderShadows(float* vertices, float* coords, int triangleCount) = 0;
+
     /**
      * @brief renderSubModel renders model into scene
      * @param m is instance of model to render
@@ -72,6 +135,13 @@ public:
      * @param enable is true to start drawing, false to render on screen
      */
     virtual void rtt(bool enable) = 0;
+
+    /**
+     * @brief setDynamicResolution enables changing render scale, scale from init is maximum
+     * @param frameTime is wanted GPU time of frame in milliseconds, 0 disables it
+     * @param minAliasing is the lowest allowed render scale
+     */
+    virtual void setDynamicResolution(float /*frameTime*/, float /*minAliasing*/) {}
 };
 
 #endif // RENDERER_H
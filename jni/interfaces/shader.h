@@ -56,6 +56,14 @@ public:
      */
     virtual void uniformFloat(const char* name, float value) = 0;
 
+    /**
+     * @brief uniformFloat3v send array of vec3 into shader
+     * @param name is uniform name
+     * @param values is array of vector values
+     * @param count is amount of vectors
+     */
+    virtual void uniformFloat3v(const char* name, float* values, int count) = 0;
+
     /**
      * @brief uniformFloat4 send vec4 into shader
      * @param name is uniform name
@@ -10,17 +10,12 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
-#include "files/extfile.h"
-#include "files/zipfile.h"
+#include <glm/glm.hpp>
+#include <string.h>
 #include <vector>
+#include "files/pngdecoder.h"
 
-struct Texture
-{
-    int width;
-    int height;
-    unsigned char* data;
-    bool hasAlpha;
-};
+#define FRAME_UNBOUNDED 1000.0f
 
 /**
  * @brief The texture interface
@@ -32,11 +27,9 @@ public:
     int twidth, theight;    ///< Image dimensions
     unsigned int textureID; ///< Texture id
 
-    bool animated;                  ///< True if it is texture sequence
-    std::vector<texture*> anim;     ///< Animation images
-    unsigned int currentFrame;      ///< Current image
-    unsigned int currentMultiFrame; ///< Replying frames state
-    unsigned int multiFrame;        ///< Replying frames amount
+    int frameCount;         ///< Amount of animation frames in atlas, 1 for still image
+    int frameColumns;       ///< Amount of frames in one row of atlas
+    int frameRows;          ///< Amount of frame rows in atlas
 
     virtual ~texture() {}
 
@@ -46,10 +39,106 @@ public:
     virtual void apply() = 0;
 
     /**
-     * @brief setFrame set frame of animation
-     * @param frame is index of frame
+     * @brief getFrame gets placement of animation frame in atlas, texture itself has no
+     * current frame so every user of texture can show different frame
+     * @param frame is index of frame, animation repeats after last frame
+     * @return scale of texture coordinates in x,y and offset in z,w
+     */
+    glm::vec4 getFrame(int frame)
+    {
+        frame %= frameCount;
+        if (frame < 0)
+            frame += frameCount;
+        float u = 1.0f / (float)frameColumns;
+        float v = 1.0f / (float)frameRows;
+        return glm::vec4(u, v, (frame % frameColumns) * u, (frame / frameColumns) * v);
+    }
+
+    /**
+     * @brief getFrameBounds gets area of animation frame in atlas without half texel border,
+     * texture coordinates are clamped into it so filtering does not mix in neighbour frames
+     * @param frame is index of frame, animation repeats after last frame
+     * @return minimal coordinates in x,y and maximal coordinates in z,w, still image has
+     * no limit so it can be repeated
+     */
+    glm::vec4 getFrameBounds(int frame)
+    {
+        if (frameCount <= 1)
+            return glm::vec4(-FRAME_UNBOUNDED, -FRAME_UNBOUNDED, FRAME_UNBOUNDED, FRAME_UNBOUNDED);
+        glm::vec4 placement = getFrame(frame);
+        float u = 0.5f / (float)twidth;
+        float v = 0.5f / (float)theight;
+        return glm::vec4(placement.z + u, placement.w + v,
+                         placement.z + placement.x - u, placement.w + placement.y - v);
+    }
+
+    /**
+     * @brief setFrames sets layout of atlas
+     * @param count is amount of frames
+     * @param columns is amount of frames in one row
+     * @param rows is amount of frame rows
+     */
+    void setFrames(int count, int columns, int rows)
+    {
+        frameCount = count;
+        frameColumns = columns;
+        frameRows = rows;
+    }
+
+    /**
+     * @brief createAtlas packs image sequence into one RGBA raster, frames are placed
+     * by rows from bottom left corner, dimensions of atlas stay power of two
+     * @param frames is image sequence of the same dimensions, its rasters are released
+     * @param columns is output amount of frames in one row
+     * @param rows is output amount of frame rows
+     * @return texture raster instance
      */
-    virtual void setFrame(int frame) = 0;
+    static inline Texture createAtlas(std::vector<Texture> frames, int* columns, int* rows)
+    {
+        /// get layout
+        int count = frames.size();
+        *columns = 1;
+        while (*columns * *columns < count)
+            *columns *= 2;
+        *rows = 1;
+        while (*columns * *rows < count)
+            *rows *= 2;
+
+        /// create empty raster
+        Texture atlas;
+        int width = frames[0].width;
+        int height = frames[0].height;
+        atlas.width = width * *columns;
+        atlas.height = height * *rows;
+        atlas.hasAlpha = true;
+        atlas.data = 0;
+
+        /// frames without pixel data give atlas without pixel data
+        if (!frames[0].data)
+            return atlas;
+        atlas.data = pngdecoder::allocate(atlas.width * atlas.height * 4);
+        memset(atlas.data, 0, atlas.width * atlas.height * 4);
+
+        /// copy frames, images without alpha are converted
+        for (int i = 0; i < count; i++)
+        {
+            int channels = frames[i].hasAlpha ? 4 : 3;
+            int left = (i % *columns) * width;
+            int bottom = (i / *columns) * height;
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++)
+                {
+                    unsigned char* src = &frames[i].data[(y * width + x) * channels];
+                    unsigned char* dst = &atlas.data[((bottom + y) * atlas.width + left + x) * 4];
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                    dst[3] = channels == 4 ? src[3] : 255;
+                }
+            pngdecoder::release(frames[i]);
+        }
+        return atlas;
+    }
 
     /**
      * @brief rgb creates texture from color
@@ -65,7 +154,7 @@ public:
 
         /// create color pixel raster
         Texture texture;
-        texture.data = new unsigned char[width * height * 4];
+        texture.data = pngdecoder::allocate(width * height * 4);
         int index = 0;
         for (int x = 0; x < width; x++)
             for (int y = 0; y < height; y++)
@@ -84,60 +173,6 @@ public:
         return texture;
     }
 
-    /**
-     * @brief pngloader loads texture from png file
-     * @param filename is name of file
-     * @return texture instance
-     */
-    static inline Texture loadPNG(file* f)
-    {
-      Texture texture;
-      unsigned int sig_read = 0;
-
-      /// init PNG library
-      png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-      png_infop info_ptr = png_create_info_struct(png_ptr);
-      setjmp(png_jmpbuf(png_ptr));
-      f->accessStatic();
-      if (f->isArchive())
-        png_set_read_fn(png_ptr, NULL, png_read_zip);
-      else
-        png_set_read_fn(png_ptr, NULL, png_read_ext);
-      png_set_sig_bytes(png_ptr, sig_read);
-      png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_STRIP_16, NULL);
-      int bit_depth, color_type, interlace_type;
-      png_uint_32 width, height;
-      png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, &interlace_type, NULL, NULL);
-
-      /// get PNG type
-      texture.hasAlpha = true;
-      switch (color_type)
-      {
-          case PNG_COLOR_TYPE_RGBA:
-              texture.hasAlpha = true;
-              break;
-          case PNG_COLOR_TYPE_RGB:
-              texture.hasAlpha = false;
-              break;
-      }
-
-      /// load PNG
-      unsigned int row_bytes = png_get_rowbytes(png_ptr, info_ptr);
-      texture.data = new unsigned char[row_bytes * height];
-      png_bytepp row_pointers = png_get_rows(png_ptr, info_ptr);
-      for (unsigned int i = 0; i < height; i++)
-          memcpy(texture.data+(row_bytes * (height-1-i)), row_pointers[i], row_bytes);
-
-      /* Clean up after the read,
-       * and free any memory allocated */
-      png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-      delete f;
-
-      texture.width = width;
-      texture.height = height;
-      return texture;
-    }
-
     int instanceCount;  ///< Amount of instances
 };
 
@@ -13,14 +13,105 @@
 #else
 #include <GL/freeglut.h>
 #endif
+#include <string.h>
+#include "engine/profiler.h"
 #include "engine/scene.h"
+#include "engine/scheduler.h"
 #include "input/keyboard.h"
+#include "renderers/opengl/programcache.h"
+
+#define CAR_INFO_COUNT 20
+#define FRAME_RENDER_RATE 20
+#define FRAME_TICK_RATE 20
+#define SHADOW_VOLUME_QUALITY 0.75f
+#define TELEMETRY_CARS 1
+#define TELEMETRY_HEADER 3
+#define TELEMETRY_LAYOUT 2
+#define TELEMETRY_STRIDE 2
+#define TELEMETRY_VERSION 0
 
 int cameraCar = 0;  ///< Car camera index
 scene* scn = 0;     ///< Game scene
 
 #ifdef ANDROID
 float aliasing = 1;
+scheduler* pacing = 0;  ///< Timing of frames
+float* telemetry = 0;   ///< Shared buffer with snapshot of cars
+int telemetrySize = 0;  ///< Size of shared buffer in floats
+
+/**
+ * @brief carInfo gets information about car
+ * @param index is index of car
+ * @param type is CAR_INFO type of information
+ * @return value of information
+ */
+float carInfo(int index, int type)
+{
+    if (type == 0)
+        return scn->getCar(index)->speed;
+    if (type == 1)
+        return scn->getCar(index)->control->getGas();
+    if (type == 2)
+        return scn->getCar(index)->control->getBrake();
+    if (type == 3)
+        return scn->getCar(index)->reverse ? 1 : -1;
+    if (type == 4)
+        return scn->getCar(index)->lspeed;
+    if (type == 5)
+        return scn->getCar(index)->gearLow;
+    if (type == 6)
+        return scn->getCar(index)->gearHigh;
+    if (type == 7)
+        return scn->getCar(index)->control->getNitro();
+    if (type == 8)
+        return scn->getCar(index)->gears[scn->getCar(index)->currentGear].min;
+    if (type == 9)
+        return scn->getCar(index)->gears[scn->getCar(index)->currentGear].max;
+    if (type == 10)
+        return scn->getCar(index)->n2o;
+    if (type == 11)
+        return distance(scn->getCar(cameraCar)->pos, scn->getCar(index)->pos);
+    if (type == 12) {
+        bool output = scn->getCar(index)->sndCrash;
+        scn->getCar(index)->sndCrash = false;
+        return output;
+    }
+    if (type == 13)
+        return scn->getCar(index)->sndDist;
+    if (type == 14)
+        return scn->getCar(index)->sndEngine1;
+    if (type == 15)
+        return scn->getCar(index)->sndEngine2;
+    if (type == 16)
+        return scn->getCar(index)->sndN2O;
+    if (type == 17)
+        return scn->getCar(index)->sndRate;
+    if (type == 18)
+        return scn->getCar(index)->edges->getEdgeCount() == 0 ? 9999 : scn->getCar(index)->toFinish;
+    if (type == 19)
+        return scn->getPlace(index);
+    return 0;
+}
+
+/**
+ * @brief updateTelemetry writes snapshot of all cars into shared buffer, the buffer is
+ * read on GL thread only so no synchronization is needed
+ */
+void updateTelemetry()
+{
+    if (!telemetry || !scn)
+        return;
+    int count = glm::min((int)scn->getCarCount(), (telemetrySize - TELEMETRY_HEADER) / CAR_INFO_COUNT);
+    telemetry[TELEMETRY_VERSION] = TELEMETRY_LAYOUT;
+    telemetry[TELEMETRY_CARS] = count;
+    telemetry[TELEMETRY_STRIDE] = CAR_INFO_COUNT;
+    for (int i = 0; i < count; i++)
+    {
+        float* data = telemetry + TELEMETRY_HEADER + i * CAR_INFO_COUNT;
+        for (int j = 0; j < CAR_INFO_COUNT; j++)
+            data[j] = carInfo(i, j);
+    }
+}
 
 /**
  * Java native methods
@@ -39,6 +130,8 @@ void Java_com_lvonasek_o4s_game_GameLoop_init( JNIEnv* env, jclass cls, jstring
   setZip(env->GetStringUTFChars(apkPath, &isCopy));
   std::string filename = env->GetStringUTFChars(track, &isCopy);
   scn = new scene(filename);
+  scn->setShadowMode(alias >= SHADOW_VOLUME_QUALITY ? SHADOW_VOLUME : SHADOW_BLOB);
+  pacing = new scheduler(FRAME_TICK_RATE, FRAME_RENDER_RATE);
 }
 
 /**
@@ -51,6 +144,18 @@ void Java_com_lvonasek_o4s_game_GameLoop_resize( JNIEnv* env, jobject object, ji
 {
   scn->initRenderer(w, h, aliasing);
 }
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_resolution enables dynamic resolution
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param frameTime is wanted time of frame rendering in milliseconds, 0 disables it
+ * @param minAliasing is the lowest allowed render scale
+ */
+void Java_com_lvonasek_o4s_game_GameLoop_resolution( JNIEnv* env, jobject object, jfloat frameTime, jfloat minAliasing )
+{
+  scn->setDynamicResolution(frameTime, minAliasing);
+}
+
 /**
  * @brief Java_com_lvonasek_o4s_game_GameLoop_restart restarts player car
  * @param env is instance of JNI
@@ -93,6 +198,63 @@ void Java_com_lvonasek_o4s_game_GameLoop_display( JNIEnv* env, jobject object )
   glFinish();
 }
 
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_frame does simulation ticks and renders the frame
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param ticks is amount of simulation ticks returned by waitFrame
+ */
+void Java_com_lvonasek_o4s_game_GameLoop_frame( JNIEnv* env, jobject object, jint ticks )
+{
+  for (int i = 0; i < ticks; i++)
+    scn->update();
+  if (ticks > 0)
+    updateTelemetry();
+
+  /// there are no GPU timers in GLES 2.0, time until GPU finished is used instead
+  double time = getTime();
+  scn->render(0);
+  glFinish();
+  scn->adaptResolution(getTime() - time);
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_frameRate sets wanted rates of frame scheduler
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param tickRate is amount of simulation ticks per second
+ * @param renderRate is amount of rendered frames per second
+ */
+void Java_com_lvonasek_o4s_game_GameLoop_frameRate( JNIEnv* env, jobject object, jfloat tickRate, jfloat renderRate )
+{
+  pacing->setRates(tickRate, renderRate);
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_frameStats is information about frame timing
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param type is FRAME_STATS type of information
+ */
+jfloat Java_com_lvonasek_o4s_game_GameLoop_frameStats( JNIEnv* env, jobject object, jint type )
+{
+  if (type == 0)
+    return pacing->getTargetTickRate();
+  if (type == 1)
+    return pacing->getTargetRenderRate();
+  if (type == 2)
+    return pacing->getTickRate();
+  if (type == 3)
+    return pacing->getRenderRate();
+  if (type == 4)
+    return pacing->getFrameTime(50);
+  if (type == 5)
+    return pacing->getFrameTime(90);
+  if (type == 6)
+    return pacing->getFrameTime(99);
+  return 0;
+}
+
 /**
  * @brief Java_com_lvonasek_o4s_game_GameLoop_loop is loop method
  * @param env is instance of JNI
@@ -101,6 +263,55 @@ void Java_com_lvonasek_o4s_game_GameLoop_display( JNIEnv* env, jobject object )
 void Java_com_lvonasek_o4s_game_GameLoop_loop( JNIEnv* env, jobject object )
 {
   scn->update();
+  updateTelemetry();
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_profileCount is amount of profiled sections
+ * @param env is instance of JNI
+ * @param object is asset manager
+ */
+jint Java_com_lvonasek_o4s_game_GameLoop_profileCount( JNIEnv* env, jobject object )
+{
+  return profiler::getSectionCount();
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_profileExport writes timeline of profiler
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param path is path of JSON file
+ */
+jboolean Java_com_lvonasek_o4s_game_GameLoop_profileExport( JNIEnv* env, jobject object, jstring path )
+{
+  /// string is copied, so buffer of JNI could be released
+  jboolean isCopy;
+  const char* chars = env->GetStringUTFChars(path, &isCopy);
+  std::string filename = chars;
+  env->ReleaseStringUTFChars(path, chars);
+  return profiler::exportTrace(filename);
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_profileName is name of profiled section
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param index is index of section
+ */
+jstring Java_com_lvonasek_o4s_game_GameLoop_profileName( JNIEnv* env, jobject object, jint index )
+{
+  return env->NewStringUTF(profiler::getSection(index).name);
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_profileTime is time of section in last frame
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param index is index of section
+ */
+jfloat Java_com_lvonasek_o4s_game_GameLoop_profileTime( JNIEnv* env, jobject object, jint index )
+{
+  return profiler::getSection(index).time;
 }
 
 /**
@@ -111,6 +322,7 @@ void Java_com_lvonasek_o4s_game_GameLoop_loop( JNIEnv* env, jobject object )
 void Java_com_lvonasek_o4s_game_GameLoop_unload( JNIEnv* env, jobject object )
 {
   delete scn;
+  delete pacing;
 }
 
 /**
@@ -123,6 +335,19 @@ void Java_com_lvonasek_o4s_game_GameLoop_unlock( JNIEnv* env, jobject object )
     scn->setPhysicsLocked(false);
 }
 
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_waitFrame sleeps until next frame, it is not
+ * synchronized in Java so input from UI thread is not blocked by sleeping, pacing is used
+ * only by GL thread
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @return amount of simulation ticks to do in frame
+ */
+jint Java_com_lvonasek_o4s_game_GameLoop_waitFrame( JNIEnv* env, jobject object )
+{
+  return pacing->wait();
+}
+
 /**
  * @brief Java_com_lvonasek_o4s_game_GameLoop_carCount is amount of cars
  * @param env is instance of JNI
@@ -132,54 +357,53 @@ jint Java_com_lvonasek_o4s_game_GameLoop_carCount( JNIEnv* env )
   return scn->getCarCount();
 }
 
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_carPlace is race position of car
+ * @param env is instance of JNI
+ * @param index is index of car
+ */
+jint Java_com_lvonasek_o4s_game_GameLoop_carPlace( JNIEnv* env, jobject object, jint index )
+{
+  return scn->getPlace(index);
+}
+
 /**
  * @brief Java_com_lvonasek_o4s_game_GameLoop_carState is information about car
  * @param env is instance of JNI
  */
 jfloat Java_com_lvonasek_o4s_game_GameLoop_carState( JNIEnv* env, jobject object, jint index, jint type )
 {
-    if (type == 0)
-        return scn->getCar(index)->speed;
-    if (type == 1)
-        return scn->getCar(index)->control->getGas();
-    if (type == 2)
-        return scn->getCar(index)->control->getBrake();
-    if (type == 3)
-        return scn->getCar(index)->reverse ? 1 : -1;
-    if (type == 4)
-        return scn->getCar(index)->lspeed;
-    if (type == 5)
-        return scn->getCar(index)->gearLow;
-    if (type == 6)
-        return scn->getCar(index)->gearHigh;
-    if (type == 7)
-        return scn->getCar(index)->control->getNitro();
-    if (type == 8)
-        return scn->getCar(index)->gears[scn->getCar(index)->currentGear].min;
-    if (type == 9)
-        return scn->getCar(index)->gears[scn->getCar(index)->currentGear].max;
-    if (type == 10)
-        return scn->getCar(index)->n2o;
-    if (type == 11)
-        return distance(scn->getCar(cameraCar)->pos, scn->getCar(index)->pos);
-    if (type == 12) {
-        bool output = scn->getCar(index)->sndCrash;
-        scn->getCar(index)->sndCrash = false;
-        return output;
-    }
-    if (type == 13)
-        return scn->getCar(index)->sndDist;
-    if (type == 14)
-        return scn->getCar(index)->sndEngine1;
-    if (type == 15)
-        return scn->getCar(index)->sndEngine2;
-    if (type == 16)
-        return scn->getCar(index)->sndN2O;
-    if (type == 17)
-        return scn->getCar(index)->sndRate;
-    if (type == 18)
-        return scn->getCar(index)->edges.empty() ? 9999 : scn->getCar(index)->toFinish;
-    return 0;
+    return carInfo(index, type);
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_shaderCache sets directory of linked shaders
+ * @param env is instance of JNI
+ * @param path is path of writable directory
+ */
+void Java_com_lvonasek_o4s_game_GameLoop_shaderCache( JNIEnv* env, jobject object, jstring path )
+{
+  /// string is copied, so buffer of JNI could be released
+  jboolean isCopy;
+  const char* chars = env->GetStringUTFChars(path, &isCopy);
+  std::string directory = chars;
+  env->ReleaseStringUTFChars(path, chars);
+  programcache::setDirectory(directory);
+}
+
+/**
+ * @brief Java_com_lvonasek_o4s_game_GameLoop_telemetry registers buffer for car snapshots
+ * @param env is instance of JNI
+ * @param object is asset manager
+ * @param buffer is direct byte buffer in native byte order
+ */
+void Java_com_lvonasek_o4s_game_GameLoop_telemetry( JNIEnv* env, jobject object, jobject buffer )
+{
+    telemetry = (float*)env->GetDirectBufferAddress(buffer);
+    telemetrySize = env->GetDirectBufferCapacity(buffer) / sizeof(float);
+    if (telemetrySize < TELEMETRY_HEADER)
+        telemetry = 0;
+    updateTelemetry();
 }
 }
 #else
@@ -293,10 +517,27 @@ int main(int argc, char** argv)
     glutKeyboardFunc(keyboardDown);
     glutKeyboardUpFunc(keyboardUp);
 
+    /// linked shaders are cached only when directory is given
+    for (int i = 1; i + 1 < argc; i++)
+        if (strcmp(argv[i], "--shader-cache") == 0)
+            programcache::setDirectory(argv[i + 1]);
+
     /// load data
     scn = new scene("#assets/tracks/winter-day.o4scfg");
     scn->setPhysicsLocked(false);
 
+    /// record or replay inputs
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+            scn->recordInput(argv[i + 1]);
+        else if (strcmp(argv[i], "--replay") == 0)
+            scn->replayInput(argv[i + 1]);
+    }
+    for (int i = 1; i < argc; i++)
+        if (strcmp(argv[i], "--blob-shadows") == 0)
+            scn->setShadowMode(SHADOW_BLOB);
+
     /// start loop
     atexit(unload);
     glutTimerFunc(0,idle,0);
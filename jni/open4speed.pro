@@ -2,6 +2,7 @@
 # Project created by QtCreator 2011-11-11T16:55:36
 # -------------------------------------------------
 LIBS += -lglut \
+    -lpthread \
     -lGL \
     -lGLU \
     -lX11 \
@@ -29,15 +30,29 @@ SOURCES += \
     engine/math.cpp \
     engine/matrices.cpp \
     engine/model.cpp \
+    engine/particles.cpp \
+    engine/profiler.cpp \
+    engine/renderstate.cpp \
+    engine/resolution.cpp \
     engine/scene.cpp \
+    engine/scheduler.cpp \
+    engine/track.cpp \
     files/extfile.cpp \
+    files/pngdecoder.cpp \
     files/zipfile.cpp \
+    input/aigroup.cpp \
     input/airacer.cpp \
     input/keyboard.cpp \
+    input/recorder.cpp \
+    input/replay.cpp \
+    physics/bullet/batchraycaster.cpp \
     physics/bullet/bullet.cpp \
+    physics/bullet/parallelworld.cpp \
+    renderers/null/nullrenderer.cpp \
     renderers/opengl/gles20.cpp \
     renderers/opengl/glsl.cpp \
     renderers/opengl/gltexture.cpp \
+    renderers/opengl/programcache.cpp \
     open4speed.cpp
 HEADERS += \
     engine/car.h \
@@ -45,11 +60,21 @@ HEADERS += \
     engine/math.h \
     engine/matrices.h \
     engine/model.h \
+    engine/particles.h \
+    engine/profiler.h \
+    engine/renderstate.h \
+    engine/resolution.h \
     engine/scene.h \
+    engine/scheduler.h \
+    engine/track.h \
     files/extfile.h \
+    files/pngdecoder.h \
     files/zipfile.h \
+    input/aigroup.h \
     input/airacer.h \
     input/keyboard.h \
+    input/recorder.h \
+    input/replay.h \
     interfaces/file.h \
     interfaces/input.h \
     interfaces/materialLoader.h \
@@ -57,8 +82,15 @@ HEADERS += \
     interfaces/renderer.h \
     interfaces/shader.h \
     interfaces/texture.h \
+    physics/bullet/batchraycaster.h \
     physics/bullet/bullet.h \
+    physics/bullet/parallelworld.h \
+    renderers/null/nullrenderer.h \
+    renderers/null/nullshader.h \
+    renderers/null/nulltexture.h \
     renderers/opengl/gles20.h \
     renderers/opengl/glsl.h \
-    renderers/opengl/gltexture.h
+    renderers/opengl/gltexture.h \
+    renderers/opengl/programcache.h
 INCLUDEPATH += ../support/bullet3-2.83.7
+DEFINES += BT_NO_PROFILE
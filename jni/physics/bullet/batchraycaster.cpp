@@ -0,0 +1,286 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       batchraycaster.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Vehicle raycaster which casts wheel rays of all cars in one batch. Every
+ *             car is one packet of rays tested together against the track meshes.
+**/
+///----------------------------------------------------------------------------------------
+
+#include "physics/bullet/batchraycaster.h"
+
+#define EDGE_TOLERANCE -0.0001
+
+/**
+ * @brief The broadphase callback collecting objects around packet
+ */
+struct packetObjects : public btBroadphaseAabbCallback
+{
+    std::vector<btCollisionObject*> objects;    ///< Found objects
+
+    virtual bool process(const btBroadphaseProxy* proxy)
+    {
+        objects.push_back((btCollisionObject*)proxy->m_clientObject);
+        return true;
+    }
+};
+
+/**
+ * @brief The triangle callback testing all rays of packet against triangle
+ */
+struct packetTriangles : public btTriangleCallback
+{
+    rayPacket* packet;  ///< Tested rays
+
+    /**
+     * @brief processTriangle is the same test as btTriangleRaycastCallback does, the
+     * triangle part is computed once and the ray part is done for all rays of packet
+     * @param triangle is array of three vertices
+     * @param partId is unused
+     * @param triangleIndex is unused
+     */
+    virtual void processTriangle(btVector3* triangle, int /*partId*/, int /*triangleIndex*/)
+    {
+        /// triangle part
+        const btVector3& vert0 = triangle[0];
+        const btVector3& vert1 = triangle[1];
+        const btVector3& vert2 = triangle[2];
+        btVector3 normal = (vert1 - vert0).cross(vert2 - vert0);
+        btScalar dist = vert0.dot(normal);
+        btScalar tolerance = normal.length2() * btScalar(EDGE_TOLERANCE);
+        btScalar nx = normal.x();
+        btScalar ny = normal.y();
+        btScalar nz = normal.z();
+
+        /// ray part, branch free to let compiler vectorize it
+        btScalar distance[PACKET_SIZE];
+        bool hit[PACKET_SIZE];
+        bool any = false;
+        for (int i = 0; i < PACKET_SIZE; i++)
+        {
+            btScalar da = nx * packet->fromX[i] + ny * packet->fromY[i] + nz * packet->fromZ[i] - dist;
+            btScalar db = nx * packet->toX[i] + ny * packet->toY[i] + nz * packet->toZ[i] - dist;
+            btScalar d = da / (da - db);
+            btScalar s = btScalar(1.0) - d;
+            btScalar px = s * packet->fromX[i] + d * packet->toX[i];
+            btScalar py = s * packet->fromY[i] + d * packet->toY[i];
+            btScalar pz = s * packet->fromZ[i] + d * packet->toZ[i];
+
+            /// edge tests
+            btScalar ax = vert0.x() - px, ay = vert0.y() - py, az = vert0.z() - pz;
+            btScalar bx = vert1.x() - px, by = vert1.y() - py, bz = vert1.z() - pz;
+            btScalar cx = vert2.x() - px, cy = vert2.y() - py, cz = vert2.z() - pz;
+            btScalar e0 = (ay * bz - az * by) * nx + (az * bx - ax * bz) * ny + (ax * by - ay * bx) * nz;
+            btScalar e1 = (by * cz - bz * cy) * nx + (bz * cx - bx * cz) * ny + (bx * cy - by * cx) * nz;
+            btScalar e2 = (cy * az - cz * ay) * nx + (cz * ax - cx * az) * ny + (cx * ay - cy * ax) * nz;
+
+            hit[i] = (i < packet->count) & (da * db < btScalar(0.0)) & (d < packet->fraction[i]) &
+                     (e0 >= tolerance) & (e1 >= tolerance) & (e2 >= tolerance);
+            distance[i] = da;
+            any |= hit[i];
+            packet->fraction[i] = hit[i] ? d : packet->fraction[i];
+        }
+        if (!any)
+            return;
+
+        /// store normals of hits
+        normal.normalize();
+        for (int i = 0; i < PACKET_SIZE; i++)
+            if (hit[i])
+                packet->normal[i] = distance[i] <= btScalar(0.0) ? -normal : normal;
+    }
+};
+
+/**
+ * @brief batchraycaster constructor
+ * @param world is dynamics world to cast rays in
+ * @param vehicles is list of all vehicles in world
+ */
+batchraycaster::batchraycaster(btDynamicsWorld* world, std::vector<btRaycastVehicle*>* vehicles) : fallback(world)
+{
+    this->world = world;
+    this->vehicles = vehicles;
+    cursor = 0;
+    valid = false;
+}
+
+/**
+ * @brief castRay gets result of wheel ray, the batch is cast on first request
+ * @param from is ray start
+ * @param to is ray end
+ * @param result is output hit information
+ * @return hit body or 0
+ */
+void* batchraycaster::castRay(const btVector3& from, const btVector3& to, btVehicleRaycasterResult& result)
+{
+    if (!valid)
+        castBatch();
+
+    /// rays are requested in the same order as they were cast
+    for (unsigned int i = 0; i < rays.size(); i++)
+    {
+        wheelRay& ray = rays[(cursor + i) % rays.size()];
+        if ((ray.from == from) && (ray.to == to))
+        {
+            cursor = (cursor + i + 1) % rays.size();
+            result = ray.result;
+            return ray.object;
+        }
+    }
+
+    /// chassis moved after batch was cast
+    return fallback.castRay(from, to, result);
+}
+
+/**
+ * @brief castBatch casts rays of all wheels of all vehicles
+ */
+void batchraycaster::castBatch()
+{
+    rays.clear();
+    for (unsigned int i = 0; i < vehicles->size(); i++)
+    {
+        /// cars out of simulation have no rays
+        btRaycastVehicle* vehicle = (*vehicles)[i];
+        if (!vehicle->getRigidBody()->getBroadphaseHandle())
+            continue;
+
+        /// get rays the same way as btRaycastVehicle::rayCast does
+        const btTransform& chassis = vehicle->getChassisWorldTransform();
+        unsigned int first = rays.size();
+        for (int j = 0; j < vehicle->getNumWheels(); j++)
+        {
+            btWheelInfo& wheel = vehicle->getWheelInfo(j);
+            btScalar length = wheel.getSuspensionRestLength() + wheel.m_wheelsRadius;
+            wheelRay ray;
+            ray.from = chassis(wheel.m_chassisConnectionPointCS);
+            ray.to = ray.from + (chassis.getBasis() * wheel.m_wheelDirectionCS) * length;
+            ray.object = 0;
+            rays.push_back(ray);
+        }
+
+        /// cast packets
+        for (unsigned int j = first; j < rays.size(); j += PACKET_SIZE)
+            castPacket(&rays[j], btMin((int)(rays.size() - j), PACKET_SIZE));
+    }
+    cursor = 0;
+    valid = true;
+}
+
+/**
+ * @brief castPacket casts rays of one vehicle
+ * @param rays is first ray of the vehicle
+ * @param count is amount of rays (maximal PACKET_SIZE)
+ */
+void batchraycaster::castPacket(wheelRay* rays, int count)
+{
+    /// find objects around all rays
+    btVector3 aabbMin = rays[0].from;
+    btVector3 aabbMax = rays[0].from;
+    for (int i = 0; i < count; i++)
+    {
+        aabbMin.setMin(rays[i].from);
+        aabbMin.setMin(rays[i].to);
+        aabbMax.setMax(rays[i].from);
+        aabbMax.setMax(rays[i].to);
+    }
+    packetObjects candidates;
+    world->getBroadphase()->aabbTest(aabbMin, aabbMax, candidates);
+
+    /// closest hits of packet
+    btScalar fraction[PACKET_SIZE];
+    btVector3 normal[PACKET_SIZE];
+    const btCollisionObject* object[PACKET_SIZE];
+    for (int i = 0; i < count; i++)
+    {
+        fraction[i] = btScalar(1.0);
+        object[i] = 0;
+    }
+
+    for (unsigned int k = 0; k < candidates.objects.size(); k++)
+    {
+        btCollisionObject* o = candidates.objects[k];
+        btCollisionWorld::ClosestRayResultCallback filter(rays[0].from, rays[0].to);
+        if (!filter.needsCollision(o->getBroadphaseHandle()))
+            continue;
+
+        if (o->getCollisionShape()->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE)
+        {
+            /// all rays against mesh in one traversal
+            btBvhTriangleMeshShape* mesh = (btBvhTriangleMeshShape*)o->getCollisionShape();
+            btTransform toLocal = o->getWorldTransform().inverse();
+            rayPacket packet;
+            packet.count = count;
+            btVector3 localMin, localMax;
+            for (int i = 0; i < PACKET_SIZE; i++)
+            {
+                int j = btMin(i, count - 1);
+                btVector3 from = toLocal * rays[j].from;
+                btVector3 to = toLocal * rays[j].to;
+                packet.fromX[i] = from.x();
+                packet.fromY[i] = from.y();
+                packet.fromZ[i] = from.z();
+                packet.toX[i] = to.x();
+                packet.toY[i] = to.y();
+                packet.toZ[i] = to.z();
+                packet.fraction[i] = fraction[j];
+                if (i == 0)
+                {
+                    localMin = from;
+                    localMax = from;
+                }
+                localMin.setMin(from);
+                localMin.setMin(to);
+                localMax.setMax(from);
+                localMax.setMax(to);
+            }
+            packetTriangles triangles;
+            triangles.packet = &packet;
+            mesh->processAllTriangles(&triangles, localMin, localMax);
+            for (int i = 0; i < count; i++)
+            {
+                if (packet.fraction[i] < fraction[i])
+                {
+                    fraction[i] = packet.fraction[i];
+                    normal[i] = o->getWorldTransform().getBasis() * packet.normal[i];
+                    object[i] = o;
+                }
+            }
+        } else
+        {
+            /// other shapes ray by ray
+            for (int i = 0; i < count; i++)
+            {
+                btTransform from, to;
+                from.setIdentity();
+                from.setOrigin(rays[i].from);
+                to.setIdentity();
+                to.setOrigin(rays[i].to);
+                btCollisionWorld::ClosestRayResultCallback callback(rays[i].from, rays[i].to);
+                callback.m_closestHitFraction = fraction[i];
+                btCollisionWorld::rayTestSingle(from, to, o, o->getCollisionShape(), o->getWorldTransform(), callback);
+                if (callback.hasHit() && (callback.m_closestHitFraction < fraction[i]))
+                {
+                    fraction[i] = callback.m_closestHitFraction;
+                    normal[i] = callback.m_hitNormalWorld;
+                    object[i] = o;
+                }
+            }
+        }
+    }
+
+    /// write results the same way as btDefaultVehicleRaycaster does
+    for (int i = 0; i < count; i++)
+    {
+        const btRigidBody* body = object[i] ? btRigidBody::upcast(object[i]) : 0;
+        if (body && body->hasContactResponse())
+        {
+            rays[i].result.m_hitPointInWorld.setInterpolate3(rays[i].from, rays[i].to, fraction[i]);
+            rays[i].result.m_hitNormalInWorld = normal[i];
+            rays[i].result.m_hitNormalInWorld.normalize();
+            rays[i].result.m_distFraction = fraction[i];
+            rays[i].object = (void*)body;
+        }
+    }
+}
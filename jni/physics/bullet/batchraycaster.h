@@ -0,0 +1,93 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       batchraycaster.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Vehicle raycaster which casts wheel rays of all cars in one batch. Every
+ *             car is one packet of rays tested together against the track meshes.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef BATCHRAYCASTER_H
+#define BATCHRAYCASTER_H
+
+#include <vector>
+#include <BulletDynamics/Vehicle/btRaycastVehicle.h>
+#include <btBulletDynamicsCommon.h>
+
+#define PACKET_SIZE 4
+
+/**
+ * @brief The wheel ray struct
+ */
+struct wheelRay
+{
+    btVector3 from;                                         ///< Ray start
+    btVector3 to;                                           ///< Ray end
+    void* object;                                           ///< Hit body or 0
+    btVehicleRaycaster::btVehicleRaycasterResult result;    ///< Hit information
+};
+
+/**
+ * @brief The ray packet struct, rays are stored as structure of arrays
+ */
+struct rayPacket
+{
+    btScalar fromX[PACKET_SIZE], fromY[PACKET_SIZE], fromZ[PACKET_SIZE];   ///< Ray starts
+    btScalar toX[PACKET_SIZE], toY[PACKET_SIZE], toZ[PACKET_SIZE];         ///< Ray ends
+    btScalar fraction[PACKET_SIZE];                                        ///< Closest hits
+    btVector3 normal[PACKET_SIZE];                                         ///< Hit normals
+    int count;                                                             ///< Used rays
+};
+
+/**
+ * @brief The batch raycaster class
+ */
+class batchraycaster : public btVehicleRaycaster
+{
+public:
+
+    /**
+     * @brief batchraycaster constructor
+     * @param world is dynamics world to cast rays in
+     * @param vehicles is list of all vehicles in world
+     */
+    batchraycaster(btDynamicsWorld* world, std::vector<btRaycastVehicle*>* vehicles);
+
+    /**
+     * @brief castRay gets result of wheel ray, the batch is cast on first request
+     * @param from is ray start
+     * @param to is ray end
+     * @param result is output hit information
+     * @return hit body or 0
+     */
+    virtual void* castRay(const btVector3& from, const btVector3& to, btVehicleRaycasterResult& result);
+
+    /**
+     * @brief invalidate drops cached rays, it must be called when chassis moved
+     */
+    void invalidate() { valid = false; }
+
+private:
+
+    /**
+     * @brief castBatch casts rays of all wheels of all vehicles
+     */
+    void castBatch();
+
+    /**
+     * @brief castPacket casts rays of one vehicle
+     * @param rays is first ray of the vehicle
+     * @param count is amount of rays (maximal PACKET_SIZE)
+     */
+    void castPacket(wheelRay* rays, int count);
+
+    btDynamicsWorld* world;                     ///< Dynamics world
+    std::vector<btRaycastVehicle*>* vehicles;   ///< Vehicles in world
+    std::vector<wheelRay> rays;                 ///< Cached rays of current step
+    btDefaultVehicleRaycaster fallback;         ///< Raycaster for rays out of batch
+    unsigned int cursor;                        ///< Index of next expected ray
+    bool valid;                                 ///< Information if cache is up to date
+};
+
+#endif // BATCHRAYCASTER_H
@@ -8,9 +8,11 @@
 **/
 ///----------------------------------------------------------------------------------------
 
+#include "engine/profiler.h"
 #include "physics/bullet/bullet.h"
 
 #define BRAKE_ASPECT 1
+#define DYNAMIC_ACTIVE_DISTANCE 50
 #define DYNAMIC_DAMPING 10
 #define DYNAMIC_FRICTION 500
 #define DYNAMIC_GRAVITATION 10
@@ -18,7 +20,11 @@
 #define ENGINE_MAX_SPEED 300
 #define GAS_ASPECT 0.00005
 #define GRAVITATION 10
+#define OFFTRACK_DISTANCE 20
 #define OVERSPEED_BRAKING 0.2
+#define RESET_DELAY 60
+#define RESET_DELAY_OFFTRACK 20
+#define RESPAWN_DISTANCE 100
 #define ROLL_INFLUENCE 0.001
 #define SKIN_FRICTION 5
 #define SPEED_DECREASE 50
@@ -33,11 +39,56 @@
 #define VEHICLE_STEP 100
 #define WHEEL_FRICTION 300
 #define WORLD_LIMIT 50
+#define WORLD_FIXED_STEP (1 / 60.0f)
 #define WORLD_STEP 100
 #define WORLD_SUBSTEP 4
+#define WORLD_TICK (WORLD_SUBSTEP * WORLD_FIXED_STEP)
 
 pthread_mutex_t bullet::mutex = PTHREAD_MUTEX_INITIALIZER;  ///< Lock for multithreading
 
+/**
+ * @brief tickStarted drops cached wheel rays before every internal step and in
+ * deterministic mode resets solvers into the same state
+ * @param world is dynamics world
+ * @param timeStep is step time
+ */
+static void tickStarted(btDynamicsWorld* world, btScalar /*timeStep*/)
+{
+    bullet* instance = (bullet*)world->getWorldUserInfo();
+    instance->m_vehicleRayCaster->invalidate();
+    if (instance->deterministic)
+        instance->m_dynamicsWorld->setRandSeed(0);
+}
+
+/**
+ * @brief dynamicState constructor
+ * @param transform is initial transformation of object
+ * @param matrix is float[16] of model to keep updated
+ */
+dynamicState::dynamicState(const btTransform& transform, float* matrix)
+{
+    this->matrix = matrix;
+    current = transform;
+    current.getOpenGLMatrix(matrix);
+}
+
+/**
+ * @brief setWorldTransform is called by simulation when object moved
+ * @param transform is new transformation
+ */
+void dynamicState::setWorldTransform(const btTransform& transform)
+{
+    /// keep last valid matrix
+    float m[16];
+    transform.getOpenGLMatrix(m);
+    for (int i = 0; i < 16; i++)
+        if (isnan(m[i]))
+            return;
+    current = transform;
+    for (int i = 0; i < 16; i++)
+        matrix[i] = m[i];
+}
+
 /**
  * @brief bullet destructor
  */
@@ -51,14 +102,15 @@ bullet::~bullet()
         delete vehicles[vehicles.size() - 1];
         vehicles.pop_back();
     }
-    std::map<id3d, std::vector<btRigidBody*> >::iterator itDynamic;
+    std::map<id3d, dynamicChunk>::iterator itDynamic;
     for(itDynamic = dynamicObjects.begin(); itDynamic != dynamicObjects.end(); ++itDynamic)
     {
-        while(!itDynamic->second.empty())
+        while(!itDynamic->second.bodies.empty())
         {
-            delete itDynamic->second[itDynamic->second.size() - 1]->getCollisionShape();
-            delete itDynamic->second[itDynamic->second.size() - 1];
-            itDynamic->second.pop_back();
+            delete itDynamic->second.bodies[itDynamic->second.bodies.size() - 1]->getCollisionShape();
+            delete itDynamic->second.bodies[itDynamic->second.bodies.size() - 1]->getMotionState();
+            delete itDynamic->second.bodies[itDynamic->second.bodies.size() - 1];
+            itDynamic->second.bodies.pop_back();
         }
     }
     std::map<id3d, std::vector<btCollisionObject*> >::iterator itStatic;
@@ -96,15 +148,17 @@ bullet::bullet()
     /// init engine
     active = true;
     locked = true;
+    deterministic = false;
     m_collisionConfiguration = new btDefaultCollisionConfiguration();
     m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
     btVector3 worldMin(-WORLD_LIMIT,-WORLD_LIMIT,-WORLD_LIMIT);
     btVector3 worldMax(WORLD_LIMIT,WORLD_LIMIT,WORLD_LIMIT);
     m_overlappingPairCache = new btAxisSweep3(worldMin,worldMax);
     m_constraintSolver = new btSequentialImpulseConstraintSolver();
-    m_dynamicsWorld = new btDiscreteDynamicsWorld(m_dispatcher,m_overlappingPairCache,m_constraintSolver,m_collisionConfiguration);
+    m_dynamicsWorld = new parallelworld(m_dispatcher,m_overlappingPairCache,m_constraintSolver,m_collisionConfiguration);
     m_dynamicsWorld->setGravity(btVector3(0,-GRAVITATION,0));
-    m_vehicleRayCaster = new btDefaultVehicleRaycaster(m_dynamicsWorld);
+    m_vehicleRayCaster = new batchraycaster(m_dynamicsWorld, &vehicles);
+    m_dynamicsWorld->setInternalTickCallback(tickStarted, this, true);
 }
 
 /**
@@ -179,6 +233,8 @@ void bullet::addCar(car* c)
 void bullet::addModel(model *m, id3d id)
 {
     btTriangleMesh* mesh = new btTriangleMesh();
+    dynamicChunk chunk;
+    chunk.active = false;
     bool touchable = false;
     int count = 0;
     for (unsigned int i = 0; i < m->models.size(); i++)
@@ -196,15 +252,6 @@ void bullet::addModel(model *m, id3d id)
             float h = m->models[i].reg.max.z - m->models[i].reg.min.z;
             btBoxShape* shape = new btBoxShape(btVector3(w / 2, a / 2, h / 2));
 
-            /// Set object physical values
-            btVector3 localInertia(0, 0, 0);
-            shape->calculateLocalInertia(w * a * h,localInertia);
-            btRigidBody* body = new btRigidBody(w * a * h + 1, 0, shape,localInertia);
-            dynamicObjects[id].push_back(body);
-            pthread_mutex_lock(&mutex);
-            m_dynamicsWorld->addRigidBody(body);
-            pthread_mutex_unlock(&mutex);
-
             /// Set object default transform
             btTransform tr;
             tr.setIdentity();
@@ -212,14 +259,29 @@ void bullet::addModel(model *m, id3d id)
                                    m->models[i].reg.min.y + a / 2,
                                    m->models[i].reg.min.z + h / 2));
 
+            /// Set object physical values
+            btVector3 localInertia(0, 0, 0);
+            shape->calculateLocalInertia(w * a * h,localInertia);
+            btMotionState* state = new dynamicState(tr, m->models[i].dynamicMat);
+            btRigidBody* body = new btRigidBody(w * a * h + 1, state, shape,localInertia);
+
             /// Create object
-            body->setCenterOfMassTransform(tr);
+            body->setFlags(body->getFlags() | BT_DISABLE_WORLD_GRAVITY);
             body->setFriction(DYNAMIC_FRICTION);
             body->setRollingFriction(DYNAMIC_ROLLING_FRICTION);
             body->setDamping(DYNAMIC_DAMPING, DYNAMIC_DAMPING);
             body->setGravity(btVector3(0, -GRAVITATION * DYNAMIC_GRAVITATION, 0));
             body->setActivationState(ISLAND_SLEEPING);
-            m->models[i].dynamicID = dynamicObjects[id].size();
+            btVector3 min(m->models[i].reg.min.x, m->models[i].reg.min.y, m->models[i].reg.min.z);
+            btVector3 max(m->models[i].reg.max.x, m->models[i].reg.max.y, m->models[i].reg.max.z);
+            if (chunk.bodies.empty())
+            {
+                chunk.min = min;
+                chunk.max = max;
+            }
+            chunk.min.setMin(min);
+            chunk.max.setMax(max);
+            chunk.bodies.push_back(body);
         } else if (m->models[i].touchable || !touchable) {
             btVector3 o = btVector3(m->models[i].reg.min.x, m->models[i].reg.min.y, m->models[i].reg.min.z);
             for (int j = 0; j < m->models[i].count; j++) {
@@ -254,26 +316,25 @@ void bullet::addModel(model *m, id3d id)
         pthread_mutex_unlock(&mutex);
     } else
         delete mesh;
-}
 
-/**
- * @brief getTransform counts OpenGL matrix of transformation
- * @param index is index of object
- * @param m is float[16] for output
- * @param id is 3d position index
- */
-void bullet::getTransform(int index, float* m, id3d id)
-{
-    /// get matrix
-    dynamicObjects[id][index - 1]->getCenterOfMassTransform().getOpenGLMatrix(m);
-    for (int i = 0; i < 16; i++)
+    /// dynamic objects get into simulation when a car comes close
+    if (!chunk.bodies.empty())
     {
-        if (isnan(m[i]))
+        pthread_mutex_lock(&mutex);
+        if (dynamicObjects.find(id) != dynamicObjects.end())
         {
-            for (int j = 0; j < 16; j++)
-                m[j] = (j % 5 == 0) ? 1 : 0;
-            return;
+            dynamicChunk& previous = dynamicObjects[id];
+            for (std::vector<btRigidBody*>::const_iterator it = previous.bodies.begin(); it != previous.bodies.end(); ++it)
+            {
+                if (previous.active)
+                    m_dynamicsWorld->removeRigidBody(*it);
+                chunk.bodies.push_back(*it);
+            }
+            chunk.min.setMin(previous.min);
+            chunk.max.setMax(previous.max);
         }
+        dynamicObjects[id] = chunk;
+        pthread_mutex_unlock(&mutex);
     }
 }
 
@@ -284,13 +345,16 @@ void bullet::getTransform(int index, float* m, id3d id)
 void bullet::removeModel(id3d id)
 {
     pthread_mutex_lock(&mutex);
-    for (std::vector<btRigidBody*>::const_iterator it = dynamicObjects[id].begin(); it != dynamicObjects[id].end(); ++it)
+    m_vehicleRayCaster->invalidate();
+    for (std::vector<btRigidBody*>::const_iterator it = dynamicObjects[id].bodies.begin(); it != dynamicObjects[id].bodies.end(); ++it)
     {
-        m_dynamicsWorld->removeRigidBody(*it);
+        if (dynamicObjects[id].active)
+            m_dynamicsWorld->removeRigidBody(*it);
         delete (*it)->getCollisionShape();
+        delete (*it)->getMotionState();
         delete (*it);
     }
-    dynamicObjects[id].clear();
+    dynamicObjects.erase(id);
     for (std::vector<btCollisionObject*>::const_iterator it = staticObjects[id].begin(); it != staticObjects[id].end(); ++it)
     {
         m_dynamicsWorld->removeCollisionObject(*it);
@@ -314,25 +378,71 @@ void bullet::resetCar(car* c, bool total)
 {
     c->resetRequested = false;
     if (total)
+    {
+      /// respawn on the nearest part of race path
+      int nearest = c->edges->getNearest(c->pos, RESPAWN_DISTANCE, true);
+      if (nearest >= 0)
+          c->currentEdge = nearest;
       c->setStart(c->currentEdge, 0);
-    btTransform tr;
-    tr.setIdentity();
-    tr.setOrigin(btVector3(c->pos.x,c->pos.y + 2,c->pos.z));
-    btQuaternion q;
-    q.setRotation(btVector3(0,1,0), c->rot * 3.14 / 180.0);
-    tr.setRotation(q);
-    vehicles[c->index - 1]->getRigidBody()->setCenterOfMassTransform(tr);
+    }
+    placeCar(c);
+}
 
-    /// get matrices
-    for (int i = 0; i < 4; i++)
-        vehicles[c->index - 1]->updateWheelTransform(i);
-    for (int index = 0; index < 5; index++)
+/**
+ * @brief setCarKinematic switches car between simulation and kinematic movement
+ * @param c is instance of car
+ * @param kinematic is true to take car out of simulation
+ */
+void bullet::setCarKinematic(car* c, bool kinematic)
+{
+    if (c->kinematic == kinematic)
+        return;
+    btRaycastVehicle* vehicle = vehicles[c->index - 1];
+    pthread_mutex_lock(&mutex);
+    if (kinematic)
     {
-        if (index > 0)
-          vehicles[c->index - 1]->getWheelInfo(index - 1).m_worldTransform.getOpenGLMatrix(c->transform[index].value);
-        else
-          vehicles[c->index - 1]->getRigidBody()->getCenterOfMassTransform().getOpenGLMatrix(c->transform[index].value);
+        m_dynamicsWorld->removeVehicle(vehicle);
+        m_dynamicsWorld->removeRigidBody(vehicle->getRigidBody());
+        c->reverse = false;
+    } else
+    {
+        /// continue with speed of kinematic movement
+        placeCar(c);
+        btVector3 step(c->pos.x - c->oldPos.x, c->pos.y - c->oldPos.y, c->pos.z - c->oldPos.z);
+        vehicle->getRigidBody()->setLinearVelocity(step / WORLD_TICK);
+        vehicle->getRigidBody()->setAngularVelocity(btVector3(0, 0, 0));
+        m_dynamicsWorld->addRigidBody(vehicle->getRigidBody());
+        m_dynamicsWorld->addVehicle(vehicle);
+    }
+    c->kinematic = kinematic;
+    pthread_mutex_unlock(&mutex);
+}
+
+/**
+ * @brief setDeterministic sets simulation into reproducible mode
+ * @param on is true to get the same result from the same inputs
+ */
+void bullet::setDeterministic(bool on)
+{
+    pthread_mutex_lock(&mutex);
+    deterministic = on;
+    if (on)
+    {
+        m_dynamicsWorld->getSolverInfo().m_solverMode &= ~SOLVER_RANDMIZE_ORDER;
+        m_dynamicsWorld->setRandSeed(0);
     }
+    pthread_mutex_unlock(&mutex);
+}
+
+/**
+ * @brief setThreads sets amount of threads for solving simulation islands
+ * @param count is amount of threads, 1 for serial simulation
+ */
+void bullet::setThreads(int count)
+{
+    pthread_mutex_lock(&mutex);
+    m_dynamicsWorld->setThreads(count);
+    pthread_mutex_unlock(&mutex);
 }
 
 /**
@@ -341,6 +451,14 @@ void bullet::resetCar(car* c, bool total)
  */
 void bullet::updateCar(car* c)
 {
+    /// car out of simulation only follows its position
+    if (c->kinematic)
+    {
+        c->resetAllowed = false;
+        placeCar(c);
+        return;
+    }
+
     /// get direction
     if ((int)vehicles[c->index - 1]->getCurrentSpeedKmHour() < 0)
         c->reverse = true;
@@ -424,7 +542,8 @@ void bullet::updateCar(car* c)
     /// Reset car
     if ((c->speed < 5) && active && !locked)
     {
-        if (c->onRoof > 60)
+        bool offTrack = (c->edges->getEdgeCount() > 0) && (c->edges->getNearest(c->pos, OFFTRACK_DISTANCE, true) < 0);
+        if (c->onRoof > (offTrack ? RESET_DELAY_OFFTRACK : RESET_DELAY))
         {
             c->resetAllowed = true;
             if ((int)c->index - 1 != 0)
@@ -467,7 +586,75 @@ void bullet::updateCar(car* c)
  */
 void bullet::updateWorld()
 {
+    PROFILE("bullet::updateWorld");
     pthread_mutex_lock(&mutex);
-    m_dynamicsWorld->stepSimulation(WORLD_STEP, WORLD_SUBSTEP);
+    activateChunks();
+    m_dynamicsWorld->stepSimulation(WORLD_STEP, WORLD_SUBSTEP, WORLD_FIXED_STEP);
     pthread_mutex_unlock(&mutex);
 }
+
+/**
+ * @brief activateChunks adds dynamic objects around cars into simulation and removes
+ * distant ones
+ */
+void bullet::activateChunks()
+{
+    btVector3 radius(DYNAMIC_ACTIVE_DISTANCE, DYNAMIC_ACTIVE_DISTANCE, DYNAMIC_ACTIVE_DISTANCE);
+    for (std::map<id3d, dynamicChunk>::iterator it = dynamicObjects.begin(); it != dynamicObjects.end(); ++it)
+    {
+        /// find simulated car in chunk radius
+        bool active = false;
+        btVector3 min = it->second.min - radius;
+        btVector3 max = it->second.max + radius;
+        for (unsigned int i = 0; i < vehicles.size(); i++)
+        {
+            if (!vehicles[i]->getRigidBody()->getBroadphaseHandle())
+                continue;
+            const btVector3& p = vehicles[i]->getRigidBody()->getCenterOfMassPosition();
+            if ((p.x() >= min.x()) && (p.y() >= min.y()) && (p.z() >= min.z()) &&
+                (p.x() <= max.x()) && (p.y() <= max.y()) && (p.z() <= max.z()))
+            {
+                active = true;
+                break;
+            }
+        }
+
+        /// apply change
+        if (it->second.active == active)
+            continue;
+        for (std::vector<btRigidBody*>::const_iterator b = it->second.bodies.begin(); b != it->second.bodies.end(); ++b)
+        {
+            if (active)
+                m_dynamicsWorld->addRigidBody(*b);
+            else
+                m_dynamicsWorld->removeRigidBody(*b);
+        }
+        it->second.active = active;
+    }
+}
+
+/**
+ * @brief placeCar moves car body on car position and updates car matrices
+ * @param c is instance of car
+ */
+void bullet::placeCar(car* c)
+{
+    btTransform tr;
+    tr.setIdentity();
+    tr.setOrigin(btVector3(c->pos.x,c->pos.y + 2,c->pos.z));
+    btQuaternion q;
+    q.setRotation(btVector3(0,1,0), c->rot * 3.14 / 180.0);
+    tr.setRotation(q);
+    vehicles[c->index - 1]->getRigidBody()->setCenterOfMassTransform(tr);
+
+    /// get matrices
+    for (int i = 0; i < 4; i++)
+        vehicles[c->index - 1]->updateWheelTransform(i);
+    for (int index = 0; index < 5; index++)
+    {
+        if (index > 0)
+          vehicles[c->index - 1]->getWheelInfo(index - 1).m_worldTransform.getOpenGLMatrix(c->transform[index].value);
+        else
+          vehicles[c->index - 1]->getRigidBody()->getCenterOfMassTransform().getOpenGLMatrix(c->transform[index].value);
+    }
+}
@@ -14,6 +14,49 @@
 #include <BulletDynamics/Vehicle/btRaycastVehicle.h>
 #include <btBulletDynamicsCommon.h>
 #include "interfaces/physics.h"
+#include "physics/bullet/batchraycaster.h"
+#include "physics/bullet/parallelworld.h"
+
+/**
+ * @brief The motion state which writes transformation of dynamic object into its model
+ */
+class dynamicState : public btMotionState
+{
+public:
+
+    /**
+     * @brief dynamicState constructor
+     * @param transform is initial transformation of object
+     * @param matrix is float[16] of model to keep updated
+     */
+    dynamicState(const btTransform& transform, float* matrix);
+
+    /**
+     * @brief getWorldTransform gets current transformation
+     * @param transform is output transformation
+     */
+    virtual void getWorldTransform(btTransform& transform) const { transform = current; }
+
+    /**
+     * @brief setWorldTransform is called by simulation when object moved
+     * @param transform is new transformation
+     */
+    virtual void setWorldTransform(const btTransform& transform);
+
+private:
+    btTransform current;    ///< Current transformation
+    float* matrix;          ///< OpenGL matrix of model
+};
+
+/**
+ * @brief The dynamic chunk struct
+ */
+struct dynamicChunk
+{
+    std::vector<btRigidBody*> bodies;   ///< Dynamic objects of chunk
+    btVector3 min, max;                 ///< Bounding box of objects
+    bool active;                        ///< Objects are in simulation
+};
 
 /**
  * @brief The bullet physics implementation class
@@ -25,20 +68,21 @@ public:
     /**
      * Bullet physics objects
      */
-    btDynamicsWorld* m_dynamicsWorld;
+    parallelworld* m_dynamicsWorld;
     btCollisionConfiguration* m_collisionConfiguration;
     btCollisionDispatcher* m_dispatcher;
     btBroadphaseInterface* m_overlappingPairCache;
     btConstraintSolver* m_constraintSolver;
-    btVehicleRaycaster* m_vehicleRayCaster;
+    batchraycaster* m_vehicleRayCaster;
 
     /**
      * Geometry objects
      */
-    std::map<id3d, std::vector<btRigidBody*> > dynamicObjects;
+    std::map<id3d, dynamicChunk> dynamicObjects;
     std::map<id3d, std::vector<btCollisionObject*> > staticObjects;
     std::map<id3d, std::vector<btTriangleMesh*> > staticMeshes;
     std::vector<btRaycastVehicle*> vehicles;
+    bool deterministic;     ///< Information if simulation is reproducible
 
     /**
      * @brief Construct physical model
@@ -63,14 +107,6 @@ public:
      */
     void addModel(model *m, id3d id);
 
-    /**
-     * @brief getTransform counts OpenGL matrix of transformation
-     * @param index is index of object
-     * @param m is float[16] for output
-     * @param id is 3d position index
-     */
-    void getTransform(int index, float* m, id3d id);
-
     /**
      * @brief removeModel removes model from physical engine
      * @param id is 3d position index
@@ -83,6 +119,25 @@ public:
      */
     void resetCar(car* c, bool total = true);
 
+    /**
+     * @brief setCarKinematic switches car between simulation and kinematic movement
+     * @param c is instance of car
+     * @param kinematic is true to take car out of simulation
+     */
+    void setCarKinematic(car* c, bool kinematic);
+
+    /**
+     * @brief setDeterministic sets simulation into reproducible mode
+     * @param on is true to get the same result from the same inputs
+     */
+    void setDeterministic(bool on);
+
+    /**
+     * @brief setThreads sets amount of threads for solving simulation islands
+     * @param count is amount of threads, 1 for serial simulation
+     */
+    void setThreads(int count);
+
     /**
      * @brief updateCar updates car state
      * @param c is instance of car
@@ -95,6 +150,19 @@ public:
     void updateWorld();
 
 private:
+
+    /**
+     * @brief activateChunks adds dynamic objects around cars into simulation and removes
+     * distant ones
+     */
+    void activateChunks();
+
+    /**
+     * @brief placeCar moves car body on car position and updates car matrices
+     * @param c is instance of car
+     */
+    void placeCar(car* c);
+
     static pthread_mutex_t mutex;  ///< Lock for multithreading
 };
 
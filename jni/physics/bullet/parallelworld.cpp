@@ -0,0 +1,299 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       parallelworld.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Bullet dynamics world which solves independent simulation islands on
+ *             a pool of worker threads.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
+#include "physics/bullet/parallelworld.h"
+
+/**
+ * @brief constraintIslandId gets island of constraint
+ * @param c is constraint instance
+ * @return island id
+ */
+static int constraintIslandId(const btTypedConstraint* c)
+{
+    int islandId = c->getRigidBodyA().getIslandTag();
+    if (islandId < 0)
+        islandId = c->getRigidBodyB().getIslandTag();
+    return islandId;
+}
+
+/**
+ * @brief The constraint sorting predicate
+ */
+class constraintIslandPredicate
+{
+public:
+    bool operator() (const btTypedConstraint* lhs, const btTypedConstraint* rhs) const
+    {
+        return constraintIslandId(lhs) < constraintIslandId(rhs);
+    }
+};
+
+/**
+ * @brief The island collector passes islands from island manager into world
+ */
+struct islandCollector : public btSimulationIslandManager::IslandCallback
+{
+    parallelworld* world;   ///< Target world
+
+    islandCollector(parallelworld* w) : world(w) {}
+
+    virtual void processIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds, int islandId)
+    {
+        world->addIsland(bodies, numBodies, manifolds, numManifolds, islandId);
+    }
+};
+
+/**
+ * @brief parallelworld constructor
+ * @param dispatcher is collision dispatcher
+ * @param pairCache is broadphase
+ * @param constraintSolver is solver used in serial mode
+ * @param collisionConfiguration is collision configuration
+ */
+parallelworld::parallelworld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache,
+                             btConstraintSolver* constraintSolver, btCollisionConfiguration* collisionConfiguration)
+    : btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration)
+{
+    threads = 1;
+    generation = 0;
+    pending = 0;
+    quit = false;
+    info = 0;
+    constraintCursor = 0;
+    nextJob = 0;
+    for (int i = 0; i < PARALLEL_MAX_THREADS; i++)
+    {
+        solvers[i] = 0;
+        workers[i].world = this;
+        workers[i].index = i;
+    }
+    pthread_mutex_init(&workMutex, NULL);
+    pthread_cond_init(&workStart, NULL);
+    pthread_cond_init(&workDone, NULL);
+}
+
+/**
+ * @brief parallelworld destructor
+ */
+parallelworld::~parallelworld()
+{
+    stopWorkers();
+    for (int i = 0; i < PARALLEL_MAX_THREADS; i++)
+        if (solvers[i])
+            delete solvers[i];
+    pthread_cond_destroy(&workDone);
+    pthread_cond_destroy(&workStart);
+    pthread_mutex_destroy(&workMutex);
+}
+
+/**
+ * @brief setRandSeed sets random seed of all solvers
+ * @param seed is new seed
+ */
+void parallelworld::setRandSeed(unsigned long seed)
+{
+    if (m_constraintSolver->getSolverType() == BT_SEQUENTIAL_IMPULSE_SOLVER)
+        ((btSequentialImpulseConstraintSolver*)m_constraintSolver)->setRandSeed(seed);
+    for (int i = 0; i < PARALLEL_MAX_THREADS; i++)
+        if (solvers[i])
+            solvers[i]->setRandSeed(seed);
+}
+
+/**
+ * @brief setThreads sets amount of threads used for solving islands
+ * @param count is amount of threads, 1 or less means serial mode
+ */
+void parallelworld::setThreads(int count)
+{
+    if (count < 1)
+        count = 1;
+    if (count > PARALLEL_MAX_THREADS)
+        count = PARALLEL_MAX_THREADS;
+    if (count == threads)
+        return;
+
+    stopWorkers();
+    threads = count;
+    for (int i = 0; i < threads; i++)
+        if (!solvers[i])
+            solvers[i] = new btSequentialImpulseConstraintSolver();
+    startWorkers();
+}
+
+/**
+ * @brief addIsland stores island for later solving (called by island manager)
+ * @param bodies is array of island bodies
+ * @param numBodies is amount of bodies
+ * @param manifolds is array of island contact manifolds
+ * @param numManifolds is amount of manifolds
+ * @param islandId is island id
+ */
+void parallelworld::addIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds, int islandId)
+{
+    /// find constraints of island, islands come in ascending order as the constraints are sorted
+    int constraintCount = 0;
+    int numConstraints = m_sortedConstraints.size();
+    while ((constraintCursor < numConstraints) && (constraintIslandId(m_sortedConstraints[constraintCursor]) < islandId))
+        constraintCursor++;
+    int constraintStart = constraintCursor;
+    while ((constraintStart + constraintCount < numConstraints) &&
+           (constraintIslandId(m_sortedConstraints[constraintStart + constraintCount]) == islandId))
+        constraintCount++;
+
+    /// small islands are merged into batches the same way as in serial mode
+    if (jobs.empty() || (jobs.back().manifoldCount + jobs.back().constraintCount > info->m_minimumSolverBatchSize))
+    {
+        islandJob job;
+        job.bodyStart = bodyList.size();
+        job.bodyCount = 0;
+        job.manifoldStart = manifoldList.size();
+        job.manifoldCount = 0;
+        job.constraintStart = constraintList.size();
+        job.constraintCount = 0;
+        jobs.push_back(job);
+    }
+
+    /// copy island data, island manager reuses its body array for every island
+    islandJob& job = jobs.back();
+    for (int i = 0; i < numBodies; i++)
+        bodyList.push_back(bodies[i]);
+    for (int i = 0; i < numManifolds; i++)
+        manifoldList.push_back(manifolds[i]);
+    for (int i = 0; i < constraintCount; i++)
+        constraintList.push_back(m_sortedConstraints[constraintStart + i]);
+    job.bodyCount += numBodies;
+    job.manifoldCount += numManifolds;
+    job.constraintCount += constraintCount;
+    constraintCursor += constraintCount;
+}
+
+/**
+ * @brief solveConstraints solves all islands, in parallel if enabled
+ * @param solverInfo is solver configuration
+ */
+void parallelworld::solveConstraints(btContactSolverInfo& solverInfo)
+{
+    /// serial mode
+    if ((threads <= 1) || !getSimulationIslandManager()->getSplitIslands())
+    {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+
+    /// sort constraints by islands
+    m_sortedConstraints.resize(m_constraints.size());
+    for (int i = 0; i < m_constraints.size(); i++)
+        m_sortedConstraints[i] = m_constraints[i];
+    m_sortedConstraints.quickSort(constraintIslandPredicate());
+
+    /// collect active islands
+    info = &solverInfo;
+    bodyList.clear();
+    manifoldList.clear();
+    constraintList.clear();
+    constraintCursor = 0;
+    jobs.clear();
+    islandCollector collector(this);
+    getSimulationIslandManager()->buildAndProcessIslands(getDispatcher(), getCollisionWorld(), &collector);
+    if (jobs.empty())
+        return;
+
+    /// wake up workers and help them
+    nextJob = 0;
+    pthread_mutex_lock(&workMutex);
+    pending = threads - 1;
+    generation++;
+    pthread_cond_broadcast(&workStart);
+    pthread_mutex_unlock(&workMutex);
+    solveJobs(0);
+
+    /// wait until all islands are solved
+    pthread_mutex_lock(&workMutex);
+    while (pending > 0)
+        pthread_cond_wait(&workDone, &workMutex);
+    pthread_mutex_unlock(&workMutex);
+}
+
+/**
+ * @brief solveJobs takes island jobs until there is none left
+ * @param index is index of solver to use
+ */
+void parallelworld::solveJobs(int index)
+{
+    while (true)
+    {
+        int job = __sync_fetch_and_add(&nextJob, 1);
+        if (job >= (int)jobs.size())
+            return;
+        islandJob& j = jobs[job];
+        btCollisionObject** bodies = j.bodyCount ? &bodyList[j.bodyStart] : 0;
+        btPersistentManifold** manifolds = j.manifoldCount ? &manifoldList[j.manifoldStart] : 0;
+        btTypedConstraint** constraints = j.constraintCount ? &constraintList[j.constraintStart] : 0;
+        solvers[index]->solveGroup(bodies, j.bodyCount, manifolds, j.manifoldCount, constraints, j.constraintCount,
+                                   *info, 0, getDispatcher());
+    }
+}
+
+/**
+ * @brief startWorkers creates worker threads
+ */
+void parallelworld::startWorkers()
+{
+    quit = false;
+    for (int i = 1; i < threads; i++)
+    {
+        workers[i].generation = generation;
+        pthread_create(&workers[i].thread, NULL, workerLoop, &workers[i]);
+    }
+}
+
+/**
+ * @brief stopWorkers joins all worker threads
+ */
+void parallelworld::stopWorkers()
+{
+    pthread_mutex_lock(&workMutex);
+    quit = true;
+    pthread_cond_broadcast(&workStart);
+    pthread_mutex_unlock(&workMutex);
+    for (int i = 1; i < threads; i++)
+        pthread_join(workers[i].thread, NULL);
+}
+
+/**
+ * @brief workerLoop is cycle of worker thread
+ * @param ptr is islandWorker instance
+ * @return 0
+ */
+void* parallelworld::workerLoop(void* ptr)
+{
+    islandWorker* worker = (islandWorker*)ptr;
+    parallelworld* w = worker->world;
+    pthread_mutex_lock(&w->workMutex);
+    while (true)
+    {
+        while (!w->quit && (worker->generation == w->generation))
+            pthread_cond_wait(&w->workStart, &w->workMutex);
+        if (w->quit)
+            break;
+        worker->generation = w->generation;
+        pthread_mutex_unlock(&w->workMutex);
+
+        w->solveJobs(worker->index);
+
+        pthread_mutex_lock(&w->workMutex);
+        w->pending--;
+        if (w->pending == 0)
+            pthread_cond_signal(&w->workDone);
+    }
+    pthread_mutex_unlock(&w->workMutex);
+    return 0;
+}
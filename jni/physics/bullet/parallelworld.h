@@ -0,0 +1,148 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       parallelworld.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Bullet dynamics world which solves independent simulation islands on
+ *             a pool of worker threads.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef PARALLELWORLD_H
+#define PARALLELWORLD_H
+
+#include <pthread.h>
+#include <vector>
+#include <btBulletDynamicsCommon.h>
+
+#define PARALLEL_MAX_THREADS 8
+
+/**
+ * @brief The island job struct
+ */
+struct islandJob
+{
+    int bodyStart;          ///< First body in shared body array
+    int bodyCount;          ///< Amount of bodies
+    int manifoldStart;      ///< First manifold in shared manifold array
+    int manifoldCount;      ///< Amount of manifolds
+    int constraintStart;    ///< First constraint in shared constraint array
+    int constraintCount;    ///< Amount of constraints
+};
+
+class parallelworld;
+
+/**
+ * @brief The island worker struct
+ */
+struct islandWorker
+{
+    parallelworld* world;   ///< Owner of worker
+    int index;              ///< Index of worker solver
+    int generation;         ///< Last step processed by worker
+    pthread_t thread;       ///< Worker thread
+};
+
+/**
+ * @brief The parallel dynamics world class
+ */
+class parallelworld : public btDiscreteDynamicsWorld
+{
+public:
+
+    /**
+     * @brief parallelworld constructor
+     * @param dispatcher is collision dispatcher
+     * @param pairCache is broadphase
+     * @param constraintSolver is solver used in serial mode
+     * @param collisionConfiguration is collision configuration
+     */
+    parallelworld(btDispatcher* dispatcher, btBroadphaseInterface* pairCache,
+                  btConstraintSolver* constraintSolver, btCollisionConfiguration* collisionConfiguration);
+
+    /**
+     * @brief parallelworld destructor
+     */
+    virtual ~parallelworld();
+
+    /**
+     * @brief getThreads gets amount of threads used for solving islands
+     * @return amount of threads, 1 means serial mode
+     */
+    int getThreads() { return threads; }
+
+    /**
+     * @brief setRandSeed sets random seed of all solvers
+     * @param seed is new seed
+     */
+    void setRandSeed(unsigned long seed);
+
+    /**
+     * @brief setThreads sets amount of threads used for solving islands
+     * @param count is amount of threads, 1 or less means serial mode
+     */
+    void setThreads(int count);
+
+    /**
+     * @brief addIsland stores island for later solving (called by island manager)
+     * @param bodies is array of island bodies
+     * @param numBodies is amount of bodies
+     * @param manifolds is array of island contact manifolds
+     * @param numManifolds is amount of manifolds
+     * @param islandId is island id
+     */
+    void addIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds, int islandId);
+
+protected:
+
+    /**
+     * @brief solveConstraints solves all islands, in parallel if enabled
+     * @param solverInfo is solver configuration
+     */
+    virtual void solveConstraints(btContactSolverInfo& solverInfo);
+
+private:
+
+    /**
+     * @brief solveJobs takes island jobs until there is none left
+     * @param index is index of solver to use
+     */
+    void solveJobs(int index);
+
+    /**
+     * @brief startWorkers creates worker threads
+     */
+    void startWorkers();
+
+    /**
+     * @brief stopWorkers joins all worker threads
+     */
+    void stopWorkers();
+
+    /**
+     * @brief workerLoop is cycle of worker thread
+     * @param ptr is islandWorker instance
+     * @return 0
+     */
+    static void* workerLoop(void* ptr);
+
+    int threads;                                            ///< Amount of solving threads
+    btSequentialImpulseConstraintSolver* solvers[PARALLEL_MAX_THREADS]; ///< Solver per thread
+    islandWorker workers[PARALLEL_MAX_THREADS];             ///< Worker threads (index 0 unused)
+    pthread_mutex_t workMutex;                              ///< Lock for worker signalling
+    pthread_cond_t workStart;                               ///< Signal for new step
+    pthread_cond_t workDone;                                ///< Signal for finished step
+    int generation;                                         ///< Step counter for workers
+    int pending;                                            ///< Amount of busy workers
+    bool quit;                                              ///< Request to stop workers
+
+    btContactSolverInfo* info;                              ///< Solver info of current step
+    std::vector<btCollisionObject*> bodyList;               ///< Bodies of all islands
+    std::vector<btPersistentManifold*> manifoldList;        ///< Manifolds of all islands
+    std::vector<btTypedConstraint*> constraintList;         ///< Constraints of all islands
+    int constraintCursor;                                   ///< First unused sorted constraint
+    std::vector<islandJob> jobs;                            ///< Batched islands
+    volatile int nextJob;                                   ///< Next job to take
+};
+
+#endif // PARALLELWORLD_H
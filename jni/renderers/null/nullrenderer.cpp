@@ -0,0 +1,212 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       nullrenderer.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Renderer which goes through the scene as GL renderer does but draws
+ *             nothing, it counts draw calls and state changes of every frame
+**/
+///----------------------------------------------------------------------------------------
+
+#include "renderers/null/nullrenderer.h"
+#include "renderers/null/nullshader.h"
+#include "renderers/null/nulltexture.h"
+
+/**
+ * @brief nullrenderer constructor
+ */
+nullrenderer::nullrenderer()
+{
+    for (int i = 0; i < 10; i++)
+        enable[i] = true;
+    animationFrame = 0;
+    aliasing = 1;
+    width = 0;
+    height = 0;
+    currentFrame = frameLog();
+    lastFrame = frameLog();
+}
+
+/**
+ * @brief createShader creates shader which does nothing
+ * @param vert is vertex shader code
+ * @param frag is fragment shader code
+ * @return shader instance
+ */
+shader* nullrenderer::createShader(std::vector<std::string> /*vert*/, std::vector<std::string> /*frag*/)
+{
+    return new nullshader();
+}
+
+/**
+ * @brief createTexture creates texture without pixel data
+ * @param raster is texture raster instance, it is released
+ * @return texture instance
+ */
+texture* nullrenderer::createTexture(Texture raster)
+{
+    return new nulltexture(raster);
+}
+
+/**
+ * @brief init inits renderer
+ * @param w is screen width
+ * @param h is screen height
+ * @param a is screen aliasing(reducing resolution)
+ */
+void nullrenderer::init(int w, int h, float a)
+{
+    aliasing = a;
+    width = w;
+    height = h;
+}
+
+/**
+ * @brief renderDynamic render dynamic objects
+ * @param geom is geometry vbo
+ * @param sh is shader to use
+ * @param txt is texture to use
+ * @param triangleCount is triangle count
+ */
+void nullrenderer::renderDynamic(float* /*vertices*/, float* normals, float* coords, shader* /*sh*/, texture* /*txt*/, int triangleCount)
+{
+    /// count the same work as GL renderer does
+    beginEffects();
+    matrix = proj_view;
+    currentFrame.drawCalls++;
+    currentFrame.triangles += triangleCount;
+    currentFrame.bytes += triangleCount * 3 * sizeof(float) * (3 + (normals ? 3 : 0) + (coords ? 2 : 0));
+    currentFrame.shaderBinds++;
+    currentFrame.textureBinds++;
+    endEffects();
+}
+
+/**
+ * @brief renderModel renders model into scene
+ * @param m is instance of model to render
+ */
+void nullrenderer::renderModel(model* m)
+{
+    beginModel();
+    for (unsigned int i = 0; i < m->models.size(); i++)
+        if (enable[m->models[i].filter] && !m->models[i].touchable)
+        {
+            currentFrame.shaderBinds++;
+            renderSubModel(&m->models[i]);
+        }
+}
+
+/**
+ * @brief renderParticles renders billboard for every particle
+ * @param x is array of particle x coordinates
+ * @param y is array of particle y coordinates
+ * @param z is array of particle z coordinates
+ * @param count is amount of particles
+ * @param sh is shader which places billboard by particle index
+ * @param billboard is model of one billboard with texture
+ */
+void nullrenderer::renderParticles(float* /*x*/, float* /*y*/, float* /*z*/, int count, shader* /*sh*/, model3d* billboard)
+{
+    /// count the same work as GL renderer does, billboards are already in GPU memory
+    beginEffects();
+    matrix = proj_view;
+    currentFrame.drawCalls += (count + PARTICLE_BATCH - 1) / PARTICLE_BATCH;
+    currentFrame.triangles += count * billboard->count;
+    currentFrame.bytes += count * 3 * sizeof(float);
+    currentFrame.shaderBinds++;
+    currentFrame.textureBinds++;
+    endEffects();
+}
+
+/**
+ * @brief renderShadow renders shadow of model into scene
+ * @param m is instance of model to render
+ */
+void nullrenderer::renderShadow(model* m)
+{
+    /// shadow volume is rendered twice, once into stencil and once on screen
+    beginShadow();
+    currentFrame.shaderBinds++;
+    shadowVolume();
+    for (unsigned int i = 0; i < m->models.size(); i++)
+        if (!m->models[i].filter)
+            renderSubModel(&m->models[i]);
+    shadowPaint();
+    for (unsigned int i = 0; i < m->models.size(); i++)
+        if (!m->models[i].filter)
+            renderSubModel(&m->models[i]);
+    endShadow();
+}
+
+/**
+ * @brief renderShadows renders blob shadows under all cars in one pass
+ * @param vertices is vertices of blobs in world space
+ * @param coords is texture coords of blobs
+ * @param triangleCount is triangle count
+ */
+void nullrenderer::renderShadows(float* /*vertices*/, float* /*coords*/, int triangleCount)
+{
+    /// count the same work as GL renderer does
+    beginBlob();
+    matrix = proj_view;
+    currentFrame.drawCalls++;
+    currentFrame.triangles += triangleCount;
+    currentFrame.bytes += triangleCount * 3 * sizeof(float) * (3 + 2);
+    currentFrame.shaderBinds++;
+    endBlob();
+}
+
+/**
+ * @brief renderSubModel renders model into scene
+ * @param m is instance of model to render
+ */
+void nullrenderer::renderSubModel(model3d *m)
+{
+    /// count matrices the same way as GL renderer does
+    subModelMatrix(m);
+
+    /// count draw call, previous screen and model texture are bound
+    beginSubModel();
+    currentFrame.drawCalls++;
+    currentFrame.triangles += m->count;
+    currentFrame.bytes += m->count * 3 * sizeof(float) * (3 + (m->normals ? 3 : 0) + (m->coords ? 2 : 0));
+    currentFrame.textureBinds += 2;
+    endSubModel();
+}
+
+/**
+ * @brief rtt enables rendering into FBO which makes posible to do reflections
+ * @param enable is true to start drawing, false to render on screen
+ */
+void nullrenderer::rtt(bool enable)
+{
+    if (enable)
+    {
+        /// start new frame
+        currentFrame = frameLog();
+        beginFrame();
+    } else
+    {
+        /// full screen quad with scene texture
+        beginComposite();
+        currentFrame.drawCalls++;
+        currentFrame.triangles += 2;
+        currentFrame.bytes += 6 * sizeof(float) * (3 + 2);
+        currentFrame.shaderBinds++;
+        currentFrame.textureBinds++;
+        endComposite();
+
+        /// finish frame
+        lastFrame = currentFrame;
+    }
+}
+
+/**
+ * @brief applyState counts change of render state
+ * @param type is one of STATE_ defines
+ * @param value is new value of state
+ */
+void nullrenderer::applyState(int /*type*/, int /*value*/)
+{
+    currentFrame.stateChanges++;
+}
@@ -0,0 +1,124 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       nullrenderer.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Renderer which goes through the scene as GL renderer does but draws
+ *             nothing, it counts draw calls and state changes of every frame
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef NULLRENDERER_H
+#define NULLRENDERER_H
+
+#include "interfaces/renderer.h"
+
+/**
+ * @brief The null renderer class
+ */
+class nullrenderer : public renderer
+{
+public:
+
+    /**
+     * @brief nullrenderer constructor
+     */
+    nullrenderer();
+
+    /**
+     * @brief createShader creates shader which does nothing
+     * @param vert is vertex shader code
+     * @param frag is fragment shader code
+     * @return shader instance
+     */
+    shader* createShader(std::vector<std::string> vert, std::vector<std::string> frag);
+
+    /**
+     * @brief createTexture creates texture without pixel data
+     * @param raster is texture raster instance, it is released
+     * @return texture instance
+     */
+    texture* createTexture(Texture raster);
+
+    /**
+     * @brief getFrameLog gets summary of last finished frame
+     * @return frame summary
+     */
+    frameLog getFrameLog() { return lastFrame; }
+
+    /**
+     * @brief init inits renderer
+     * @param w is screen width
+     * @param h is screen height
+     * @param a is screen aliasing(reducing resolution)
+     */
+    void init(int w, int h, float a);
+
+    /**
+     * @brief renderDynamic render dynamic objects
+     * @param geom is geometry vbo
+     * @param sh is shader to use
+     * @param txt is texture to use
+     * @param triangleCount is triangle count
+     */
+    void renderDynamic(float* vertices, float* normals, float* coords, shader* sh, texture* txt, int triangleCount);
+
+    /**
+     * @brief renderModel renders model into scene
+     * @param m is instance of model to render
+     */
+    void renderModel(model* m);
+
+    /**
+     * @brief renderParticles renders billboard for every particle
+     * @param x is array of particle x coordinates
+     * @param y is array of particle y coordinates
+     * @param z is array of particle z coordinates
+     * @param count is amount of particles
+     * @param sh is shader which places billboard by particle index
+     * @param billboard is model of one billboard with texture
+     */
+    void renderParticles(float* x, float* y, float* z, int count, shader* sh, model3d* billboard);
+
+    /**
+     * @brief renderShadow renders shadow of model into scene
+     * @param m is instance of model to render
+     */
+    void renderShadow(model* m);
+
+    /**
+     * @brief renderShadows renders blob shadows under all cars in one pass
+     * @param vertices is vertices of blobs in world space
+     * @param coords is texture coords of blobs
+     * @param triangleCount is triangle count
+     */
+    void renderShadows(float* vertices, float* coords, int triangleCount);
+
+    /**
+     * @brief renderSubModel renders model into scene
+     * @param m is instance of model to render
+     */
+    void renderSubModel(model3d *m);
+
+    /**
+     * @brief rtt enables rendering into FBO which makes posible to do reflections
+     * @param enable is true to start drawing, false to render on screen
+     */
+    void rtt(bool enable);
+
+protected:
+
+    /**
+     * @brief applyState counts change of render state
+     * @param type is one of STATE_ defines
+     * @param value is new value of state
+     */
+    void applyState(int type, int value);
+
+private:
+
+    frameLog currentFrame;  ///< Summary of current frame
+    frameLog lastFrame;     ///< Summary of last finished frame
+};
+
+#endif // NULLRENDERER_H
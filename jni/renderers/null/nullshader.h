@@ -0,0 +1,91 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       nullshader.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Shader which does nothing, it is used when there is no graphical context
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef NULLSHADER_H
+#define NULLSHADER_H
+
+#include "interfaces/shader.h"
+
+/**
+ * @brief The null shader class
+ */
+class nullshader : public shader
+{
+public:
+
+    /**
+     * @brief Constructor
+     */
+    nullshader() { instanceCount = 1; }
+
+    /**
+     * @brief it sets pointer to geometry
+     * @param size is amount of data
+     */
+    void attrib(unsigned int /*size*/) {}
+
+    /**
+     * @brief it sends geometry into GPU
+     * @param vertices is vertices
+     * @param normals is normals
+     * @param coords is texture coords
+     */
+    void attrib(float* /*vertices*/, float* /*normals*/, float* /*coords*/) {}
+
+    /**
+     * @brief it binds shader
+     */
+    void bind() {}
+
+    /**
+     * @brief it unbinds shader
+     */
+    void unbind() {}
+
+    /**
+     * @brief uniformInt send int into shader
+     * @param name is uniform name
+     * @param value is uniform value
+     */
+    void uniformInt(const char* /*name*/, int /*value*/) {}
+
+    /**
+     * @brief uniformFloat send float into shader
+     * @param name is uniform name
+     * @param value is uniform value
+     */
+    void uniformFloat(const char* /*name*/, float /*value*/) {}
+
+    /**
+     * @brief uniformFloat3v send array of vec3 into shader
+     * @param name is uniform name
+     * @param values is array of vector values
+     * @param count is amount of vectors
+     */
+    void uniformFloat3v(const char* /*name*/, float* /*values*/, int /*count*/) {}
+
+    /**
+     * @brief uniformFloat4 send vec4 into shader
+     * @param name is uniform name
+     * @param a is vector x value
+     * @param b is vector y value
+     * @param c is vector z value
+     * @param d is vector w value
+     */
+    void uniformFloat4(const char* /*name*/, float /*a*/, float /*b*/, float /*c*/, float /*d*/) {}
+
+    /**
+     * @brief uniformMatrix send matrix into shader
+     * @param name is uniform name
+     * @param value is uniform value
+     */
+    void uniformMatrix(const char* /*name*/, float* /*value*/) {}
+};
+
+#endif // NULLSHADER_H
@@ -0,0 +1,44 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       nulltexture.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Texture which keeps only image information, it is used when there is no
+ *             graphical context
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef NULLTEXTURE_H
+#define NULLTEXTURE_H
+
+#include "interfaces/texture.h"
+
+/**
+ * @brief The null texture class
+ */
+class nulltexture : public texture
+{
+public:
+
+    /**
+     * @brief nulltexture creates texture from raster data, the raster is released
+     * @param texture is texture raster instance
+     */
+    nulltexture(Texture texture)
+    {
+        pngdecoder::release(texture);
+        transparent = texture.hasAlpha;
+        instanceCount = 1;
+        twidth = texture.width;
+        theight = texture.height;
+        textureID = 0;
+        setFrames(1, 1, 1);
+    }
+
+    /**
+     * @brief apply applies current texture
+     */
+    void apply() {}
+};
+
+#endif // NULLTEXTURE_H
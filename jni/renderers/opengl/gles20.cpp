@@ -10,7 +10,10 @@
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/type_ptr.hpp>
 #include "engine/io.h"
+#include "engine/profiler.h"
 #include "renderers/opengl/gles20.h"
+#include "renderers/opengl/glsl.h"
+#include "renderers/opengl/gltexture.h"
 
 #ifdef ANDROID
 #define PACKED_EXTENSION "GL_OES_packed_depth_stencil"
@@ -26,6 +29,7 @@ gles20::gles20()
     /// set default values
     for (int i = 0; i < 10; i++)
         enable[i] = true;
+    animationFrame = 0;
     oddFrame = true;
 
     fboID = 0;
@@ -33,6 +37,13 @@ gles20::gles20()
     rendertexture = 0;
     scene = 0;
     shadow = 0;
+    blob = 0;
+    gpuFrame = 0;
+    gpuCurrentPass = -1;
+    gpuMeasuring = false;
+    gpuReady = false;
+    particleBuffer = 0;
+    particleBillboard = 0;
 }
 
 /**
@@ -43,8 +54,25 @@ gles20::~gles20()
     cleanup();
 }
 
+/**
+ * @brief cleanup deletes GL objects
+ */
 void gles20::cleanup()
 {
+#ifndef ANDROID
+    if (gpuReady)
+    {
+        endPass();
+        glDeleteQueries(GPU_FRAMES * GPU_QUERIES, &gpuQueries[0][0]);
+        gpuReady = false;
+    }
+#endif
+    if (particleBuffer)
+    {
+        glDeleteBuffers(1, &particleBuffer);
+        particleBuffer = 0;
+        particleBillboard = 0;
+    }
     if (fboID)
     {
         glDeleteFramebuffers(2, fboID);
@@ -73,6 +101,42 @@ void gles20::cleanup()
         delete shadow;
         shadow = 0;
     }
+    if (blob)
+    {
+        delete blob;
+        blob = 0;
+    }
+}
+
+/**
+ * @brief adaptResolution changes render scale inside FBO by measured frame time
+ * @param frameTime is measured GPU time of frame in milliseconds
+ */
+void gles20::adaptResolution(float frameTime)
+{
+    /// FBO has full screen size, only viewport and composite coords use the scale
+    aliasing = dynamicResolution.update(frameTime, aliasing);
+}
+
+/**
+ * @brief createShader creates GLSL shader
+ * @param vert is vertex shader code
+ * @param frag is fragment shader code
+ * @return shader instance
+ */
+shader* gles20::createShader(std::vector<std::string> vert, std::vector<std::string> frag)
+{
+    return new glsl(vert, frag);
+}
+
+/**
+ * @brief createTexture creates OpenGL texture
+ * @param raster is texture raster instance, it is released
+ * @return texture instance
+ */
+texture* gles20::createTexture(Texture raster)
+{
+    return new gltexture(raster);
 }
 
 /**
@@ -84,8 +148,11 @@ void gles20::cleanup()
 void gles20::init(int w, int h, float a)
 {
     aliasing = a;
+    rttScale[0] = a;
+    rttScale[1] = a;
     width = w;
     height = h;
+    dynamicResolution.setMaxScale(a);
     cleanup();
 
     //find ideal texture resolution
@@ -158,6 +225,15 @@ void gles20::init(int w, int h, float a)
     //set shaders
     scene = new glsl(getList("VERT", "#assets/shaders/scene.glsl"), getList("FRAG", "#assets/shaders/scene.glsl"));
     shadow = new glsl(getList("VERT", "#assets/shaders/shadow.glsl"), getList("FRAG", "#assets/shaders/shadow.glsl"));
+    blob = new glsl(getList("VERT", "#assets/shaders/blob.glsl"), getList("FRAG", "#assets/shaders/blob.glsl"));
+
+#ifndef ANDROID
+    /// timer queries are created once and reused
+    glGenQueries(GPU_FRAMES * GPU_QUERIES, &gpuQueries[0][0]);
+    for (int i = 0; i < GPU_FRAMES; i++)
+        gpuCount[i] = 0;
+    gpuReady = true;
+#endif
 }
 
 /**
@@ -170,26 +246,23 @@ void gles20::init(int w, int h, float a)
 void gles20::renderDynamic(float* vertices, float* normals, float* coords, shader* sh, texture* txt, int triangleCount)
 {
     /// set OpenGL state
-    glEnable(GL_BLEND);
-    glDisable(GL_DEPTH_TEST);
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE);
-    glDisable(GL_CULL_FACE);
+    beginPass(GPU_PASS_EFFECTS);
+    beginEffects();
     txt->apply();
 
     /// set matrices
     sh->bind();
-    matrix = proj_matrix * view_matrix;
+    matrix = proj_view;
     sh->uniformMatrix("u_Matrix",glm::value_ptr(matrix));
+    uniformFrame(sh, txt);
 
     /// render
     sh->attrib(vertices, normals, coords);
     glDrawArrays(GL_TRIANGLES, 0, triangleCount * 3);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     /// set previous OpenGL state
     sh->unbind();
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
+    endEffects();
 }
 
 /**
@@ -198,7 +271,8 @@ void gles20::renderDynamic(float* vertices, float* normals, float* coords, shade
  */
 void gles20::renderModel(model* m)
 {
-    glDisable(GL_CULL_FACE);
+    beginPass(GPU_PASS_SCENE);
+    beginModel();
     for (unsigned int i = 0; i < m->models.size(); i++)
         if (enable[m->models[i].filter] && !m->models[i].touchable)
         {
@@ -210,6 +284,69 @@ void gles20::renderModel(model* m)
 }
 
 
+/**
+ * @brief renderParticles renders billboard for every particle
+ * @param x is array of particle x coordinates
+ * @param y is array of particle y coordinates
+ * @param z is array of particle z coordinates
+ * @param count is amount of particles
+ * @param sh is shader which places billboard by particle index
+ * @param billboard is model of one billboard with texture
+ */
+void gles20::renderParticles(float* x, float* y, float* z, int count, shader* sh, model3d* billboard)
+{
+    /// set OpenGL state
+    beginPass(GPU_PASS_EFFECTS);
+    beginEffects();
+    billboard->texture2D->apply();
+
+    /// set matrices
+    sh->bind();
+    matrix = proj_view;
+    sh->uniformMatrix("u_Matrix",glm::value_ptr(matrix));
+    uniformFrame(sh, billboard->texture2D);
+
+    /// billboards of whole batch are uploaded once, vertex x coordinate is particle index
+    int corners = billboard->count * 3;
+    int size = PARTICLE_BATCH * corners;
+    if (!particleBuffer)
+        glGenBuffers(1, &particleBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, particleBuffer);
+    if (particleBillboard != billboard->coords)
+    {
+        std::vector<float> data(size * 5, 0.0f);
+        for (int i = 0; i < PARTICLE_BATCH; i++)
+            for (int j = 0; j < corners; j++)
+            {
+                data[(i * corners + j) * 3] = (float)i;
+                data[size * 3 + (i * corners + j) * 2 + 0] = billboard->coords[j * 2 + 0];
+                data[size * 3 + (i * corners + j) * 2 + 1] = billboard->coords[j * 2 + 1];
+            }
+        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
+        particleBillboard = billboard->coords;
+    }
+    sh->attrib(size * sizeof(float));
+
+    /// render, only positions of particles are sent
+    float positions[PARTICLE_BATCH * 3];
+    for (int first = 0; first < count; first += PARTICLE_BATCH)
+    {
+        int amount = glm::min(count - first, PARTICLE_BATCH);
+        for (int i = 0; i < amount; i++)
+        {
+            positions[i * 3 + 0] = x[first + i];
+            positions[i * 3 + 1] = y[first + i];
+            positions[i * 3 + 2] = z[first + i];
+        }
+        sh->uniformFloat3v("u_Particles", positions, amount);
+        glDrawArrays(GL_TRIANGLES, 0, amount * corners);
+    }
+
+    /// set previous OpenGL state
+    sh->unbind();
+    endEffects();
+}
+
 /**
  * @brief renderShadow renders shadow of model into scene
  * @param m is instance of model to render
@@ -219,12 +356,8 @@ void gles20::renderShadow(model* m)
     if (!rttComplete)
         return;
 
-    glDepthMask(false);
-    glEnable(GL_BLEND);
-    glEnable(GL_STENCIL_TEST);
-    glBlendFunc(GL_ONE, GL_ONE);
-    glBlendEquation(GL_FUNC_REVERSE_SUBTRACT);
-    glStencilMask(true);
+    beginPass(GPU_PASS_SHADOW);
+    beginShadow();
     current = shadow;
     current->bind();
     current->uniformFloat4("u_sun_dir", -1.5f, -3.0f, 0.0f, 0.0f);
@@ -233,20 +366,14 @@ void gles20::renderShadow(model* m)
         /// set visibility shape
         current->uniformFloat("u_pass", pass * 0.05f);
         current->uniformFloat("u_offset", 0.0f);
-        glColorMask(false, false, false, false);
-        glDepthFunc(GL_LEQUAL);
-        glStencilFunc(GL_ALWAYS, 0, 1);
-        glStencilOp(GL_KEEP,GL_KEEP,GL_ZERO);
+        shadowVolume();
         for (unsigned int i = 0; i < m->models.size(); i++)
             if (!m->models[i].filter)
                 renderSubModel(&m->models[i]);
 
         /// render shadow
         current->uniformFloat("u_offset", 0.5f);
-        glColorMask(true, true, true, true);
-        glDepthFunc(GL_GEQUAL);
-        glStencilFunc(GL_EQUAL, 0, 1);
-        glStencilOp(GL_KEEP,GL_KEEP, GL_INCR);
+        shadowPaint();
         for (unsigned int i = 0; i < m->models.size(); i++)
             if (!m->models[i].filter)
                 renderSubModel(&m->models[i]);
@@ -254,11 +381,32 @@ void gles20::renderShadow(model* m)
 
     /// set up previous state
     current->unbind();
-    glBlendEquation(GL_FUNC_ADD);
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(true);
-    glDisable(GL_STENCIL_TEST);
-    glStencilMask(false);
+    endShadow();
+}
+
+/**
+ * @brief renderShadows renders blob shadows under all cars in one pass
+ * @param vertices is vertices of blobs in world space
+ * @param coords is texture coords of blobs
+ * @param triangleCount is triangle count
+ */
+void gles20::renderShadows(float* vertices, float* coords, int triangleCount)
+{
+    /// set OpenGL state
+    beginPass(GPU_PASS_BLOB);
+    beginBlob();
+    current = blob;
+    current->bind();
+    matrix = proj_view;
+    current->uniformMatrix("u_Matrix", glm::value_ptr(matrix));
+
+    /// render
+    current->attrib(vertices, 0, coords);
+    glDrawArrays(GL_TRIANGLES, 0, triangleCount * 3);
+
+    /// set up previous state
+    current->unbind();
+    endBlob();
 }
 
 /**
@@ -268,68 +416,35 @@ void gles20::renderShadow(model* m)
 void gles20::renderSubModel(model3d *m)
 {
     /// set model matrix
-    glm::mat4x4 modelView;
-    if (m->dynamic)
-    {
-        float w = m->reg.max.x - m->reg.min.x;
-        float a = m->reg.max.y - m->reg.min.y;
-        float h = m->reg.max.z - m->reg.min.z;
-        glm::mat4x4 translation(
-            1,0,0,0,
-            0,1,0,0,
-            0,0,1,0,
-            -w/2, -a/2, -h/2, 1
-        );
-        glm::mat4x4 dynamic(
-            m->dynamicMat[0], m->dynamicMat[1], m->dynamicMat[2], m->dynamicMat[3],
-            m->dynamicMat[4], m->dynamicMat[5], m->dynamicMat[6], m->dynamicMat[7],
-            m->dynamicMat[8], m->dynamicMat[9], m->dynamicMat[10], m->dynamicMat[11],
-            m->dynamicMat[12], m->dynamicMat[13], m->dynamicMat[14], m->dynamicMat[15]
-        );
-        modelMat = dynamic * translation;
-        modelView = view_matrix * modelMat;
-    } else
-    {
-        glm::mat4x4 translation(
-            1,0,0,0,
-            0,1,0,0,
-            0,0,1,0,
-            m->reg.min.x, m->reg.min.y, m->reg.min.z, 1
-        );
-        modelMat = matrix_result * translation;
-        modelView = view_matrix * modelMat;
-    }
-    glm::mat4x4 projView = proj_matrix * view_matrix;
+    subModelMatrix(m);
 
     /// set matrices
     current->uniformMatrix("u_ModelMatrix",glm::value_ptr(modelMat));
     current->uniformMatrix("u_ViewMatrix",glm::value_ptr(view_matrix));
     current->uniformMatrix("u_ModelViewMatrix",glm::value_ptr(modelView));
-    current->uniformMatrix("u_ProjViewMatrix",glm::value_ptr(projView));
+    current->uniformMatrix("u_ProjViewMatrix",glm::value_ptr(proj_view));
     current->uniformMatrix("u_ProjectionMatrix",glm::value_ptr(proj_matrix));
-    matrix = proj_matrix * modelView;
     current->uniformMatrix("u_Matrix",glm::value_ptr(matrix));
 
     /// previous screen
-    glActiveTexture( GL_TEXTURE1 );
-    glBindTexture(GL_TEXTURE_2D, rendertexture[oddFrame]);
+    beginSubModel();
     current->uniformInt("EnvMap1", 1);
 
     /// set texture
-    glActiveTexture( GL_TEXTURE0 );
     m->texture2D->apply();
     current->uniformInt("color_texture", 0);
+    uniformFrame(current, m->texture2D);
 
     /// set uniforms
-    current->uniformFloat("u_width", 1 / (float)width / aliasing);
-    current->uniformFloat("u_height", 1 / (float)height / aliasing);
+    current->uniformFloat("u_width", 1 / (float)width / rttScale[oddFrame]);
+    current->uniformFloat("u_height", 1 / (float)height / rttScale[oddFrame]);
     if (enable[9])
         current->uniformFloat("u_brake", 1.0f);
     else
         current->uniformFloat("u_brake", 0.0f);
     current->attrib(m->vertices, m->normals, m->coords);
     glDrawArrays(GL_TRIANGLES, 0, m->count * 3);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    endSubModel();
 }
 
 /**
@@ -340,33 +455,20 @@ void gles20::rtt(bool enable)
 {
     if (enable)
     {
-#ifndef ANDROID
-        /// start timer
-        glGenQueries(1,gpuMeasuring);
-        glBeginQuery(GL_TIME_ELAPSED, gpuMeasuring[0]);
-#endif
-        glBindFramebuffer(GL_FRAMEBUFFER, fboID[oddFrame]);
-        glViewport (0, 0, width * aliasing, height * aliasing);
-        glClearStencil(0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(true);
+        /// results of the oldest frame in pool are taken before reusing its queries
+        gpuFrame = (gpuFrame + 1) % GPU_FRAMES;
+        readPasses(gpuFrame);
+        gpuTime[gpuFrame] = getTime();
+        beginPass(GPU_PASS_SCENE);
+
+        beginFrame();
+        rttScale[oddFrame] = aliasing;
         oddFrame = !oddFrame;
     } else
     {
-#ifndef ANDROID
-        glEndQuery(GL_TIME_ELAPSED);
-
-        /// get scene counters
-        GLint gpu_time = 0;
-        glGetQueryObjectiv(gpuMeasuring[0], GL_QUERY_RESULT, &gpu_time);
-
-        GLint copy_time = 0;
-        glBeginQuery(GL_TIME_ELAPSED, gpuMeasuring[0]);
-#endif
         /// prepare rendering
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport (0, 0, width, height);
+        beginPass(GPU_PASS_COMPOSITE);
+        beginComposite();
 
         /// vertices
         float vertices[] =
@@ -379,32 +481,209 @@ void gles20::rtt(bool enable)
             +1, +1, 0,
         };
 
-        /// coords
+        /// coords, FBO could be rendered with different scale than current one
+        float scale = rttScale[oddFrame];
         float coords[] =
         {
-            0, aliasing,
+            0, scale,
             0, 0,
-            aliasing, 0,
-            0, aliasing,
-            aliasing, 0,
-            aliasing, aliasing,
+            scale, 0,
+            0, scale,
+            scale, 0,
+            scale, scale,
         };
 
         scene->bind();
         glBindTexture(GL_TEXTURE_2D, rendertexture[oddFrame]);
-        glDisable(GL_BLEND);
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(false);
         /// render
         scene->attrib(vertices, 0, coords);
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        endComposite();
+        endPass();
+    }
+}
+
+/**
+ * @brief applyState applies one change of render state into OpenGL
+ * @param type is one of STATE_ defines
+ * @param value is new value of state
+ */
+void gles20::applyState(int type, int value)
+{
+    switch (type)
+    {
+    case STATE_ARRAY_BUFFER:
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDepthMask(true);
+        break;
+    case STATE_BLEND:
+        if (value)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+        break;
+    case STATE_BLEND_FUNC:
+        glBlendFunc(value == STATE_BLEND_ALPHA ? GL_SRC_ALPHA : GL_ONE, GL_ONE);
+        break;
+    case STATE_BLEND_SUBTRACT:
+        glBlendEquation(value ? GL_FUNC_REVERSE_SUBTRACT : GL_FUNC_ADD);
+        break;
+    case STATE_CLEAR:
+        glClearStencil(0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        break;
+    case STATE_COLOR_MASK:
+        glColorMask(value, value, value, value);
+        break;
+    case STATE_CULL_FACE:
+        if (value)
+            glEnable(GL_CULL_FACE);
+        else
+            glDisable(GL_CULL_FACE);
+        break;
+    case STATE_DEPTH_GREATER:
+        glDepthFunc(value ? GL_GEQUAL : GL_LEQUAL);
+        break;
+    case STATE_DEPTH_MASK:
+        glDepthMask(value);
+        break;
+    case STATE_DEPTH_TEST:
+        if (value)
+            glEnable(GL_DEPTH_TEST);
+        else
+            glDisable(GL_DEPTH_TEST);
+        break;
+    case STATE_FRAMEBUFFER:
+        glBindFramebuffer(GL_FRAMEBUFFER, value ? fboID[oddFrame] : 0);
+        break;
+    case STATE_SCREEN_TEXTURE:
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, rendertexture[oddFrame]);
+        glActiveTexture(GL_TEXTURE0);
+        break;
+    case STATE_STENCIL_EQUAL:
+        glStencilFunc(value ? GL_EQUAL : GL_ALWAYS, 0, 1);
+        break;
+    case STATE_STENCIL_INCREMENT:
+        glStencilOp(GL_KEEP, GL_KEEP, value ? GL_INCR : GL_ZERO);
+        break;
+    case STATE_STENCIL_MASK:
+        glStencilMask(value);
+        break;
+    case STATE_STENCIL_TEST:
+        if (value)
+            glEnable(GL_STENCIL_TEST);
+        else
+            glDisable(GL_STENCIL_TEST);
+        break;
+    case STATE_VIEWPORT:
+        if (value)
+            glViewport(0, 0, width * aliasing, height * aliasing);
+        else
+            glViewport(0, 0, width, height);
+        break;
+    }
+}
+
+/**
+ * @brief beginPass starts measuring of GPU pass if it differs from current one
+ * @param pass is GPU_PASS_SCENE, GPU_PASS_SHADOW, GPU_PASS_BLOB, GPU_PASS_EFFECTS or
+ * GPU_PASS_COMPOSITE
+ */
+void gles20::beginPass(int pass)
+{
+#ifndef ANDROID
+    if (!gpuReady || (pass == gpuCurrentPass))
+        return;
+    endPass();
+    gpuCurrentPass = pass;
+
+    /// when pool of frame is full the rest of frame is not measured
+    int count = gpuCount[gpuFrame];
+    if (count < GPU_QUERIES)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, gpuQueries[gpuFrame][count]);
+        gpuPass[gpuFrame][count] = pass;
+        gpuCount[gpuFrame]++;
+        gpuMeasuring = true;
+    }
+#endif
+}
 
+/**
+ * @brief endPass finishes measuring of current GPU pass
+ */
+void gles20::endPass()
+{
 #ifndef ANDROID
+    if (gpuMeasuring)
         glEndQuery(GL_TIME_ELAPSED);
-        glGetQueryObjectiv(gpuMeasuring[0], GL_QUERY_RESULT, &copy_time);
-        printf("3D time: %dk 2D time: %dk\n", gpu_time / 1000, copy_time / 1000);
+    gpuMeasuring = false;
+    gpuCurrentPass = -1;
 #endif
+}
+
+/**
+ * @brief readPasses passes results of finished frame into profiler without waiting
+ * @param frame is index of frame in pool
+ */
+void gles20::readPasses(int frame)
+{
+#ifndef ANDROID
+    int count = gpuCount[frame];
+    gpuCount[frame] = 0;
+    if (count == 0)
+        return;
+
+    /// results come in order, frame which is still not finished is skipped
+    GLint available = 0;
+    glGetQueryObjectiv(gpuQueries[frame][count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return;
+
+    /// sum passes of frame
+    double time[GPU_PASS_COUNT];
+    for (int i = 0; i < GPU_PASS_COUNT; i++)
+        time[i] = 0;
+    for (int i = 0; i < count; i++)
+    {
+        GLuint nanoseconds = 0;
+        glGetQueryObjectuiv(gpuQueries[frame][i], GL_QUERY_RESULT, &nanoseconds);
+        time[gpuPass[frame][i]] += nanoseconds / 1000000.0;
     }
+
+    /// passes are placed one after another from start of frame
+    static const char* names[GPU_PASS_COUNT] = {"gpu::scene", "gpu::shadow_volume", "gpu::effects",
+                                                   "gpu::composite", "gpu::shadow_blob"};
+    double start = gpuTime[frame];
+    for (int i = 0; i < GPU_PASS_COUNT; i++)
+        if (time[i] > 0)
+        {
+            profiler::recordGPU(names[i], start, start + time[i]);
+            start += time[i];
+        }
+    adaptResolution(start - gpuTime[frame]);
+#endif
+}
+
+/**
+ * @brief uniformFrame sends placement of current animation frame in atlas into shader
+ * @param sh is bound shader
+ * @param txt is texture to use
+ */
+void gles20::uniformFrame(shader* sh, texture* txt)
+{
+    glm::vec4 frame = txt->getFrame(animationFrame);
+    sh->uniformFloat4("u_Frame", frame.x, frame.y, frame.z, frame.w);
+    glm::vec4 bounds = txt->getFrameBounds(animationFrame);
+    sh->uniformFloat4("u_FrameBounds", bounds.x, bounds.y, bounds.z, bounds.w);
+}
+
+/**
+ * @brief setDynamicResolution enables changing render scale, scale from init is maximum
+ * @param frameTime is wanted GPU time of frame in milliseconds, 0 disables it
+ * @param minAliasing is the lowest allowed render scale
+ */
+void gles20::setDynamicResolution(float frameTime, float minAliasing)
+{
+    dynamicResolution.setTarget(frameTime, minAliasing);
 }
@@ -20,20 +20,42 @@
 #include <GL/gl.h>
 #endif
 #include <vector>
+#include "engine/resolution.h"
 #include "interfaces/renderer.h"
 #include "renderers/opengl/glsl.h"
 
+#define GPU_FRAMES 3
+#define GPU_PASS_BLOB 4
+#define GPU_PASS_COMPOSITE 3
+#define GPU_PASS_COUNT 5
+#define GPU_PASS_EFFECTS 2
+#define GPU_PASS_SCENE 0
+#define GPU_PASS_SHADOW 1
+#define GPU_QUERIES 16
+
 /**
  * @brief The gles20 class is implementation of OpenGL ES 2.0
  */
 class gles20 : public renderer
 {
 public:
-    GLuint gpuMeasuring[1];               ///< Profiling
+    GLuint gpuQueries[GPU_FRAMES][GPU_QUERIES]; ///< Pool of timer queries
+    int gpuPass[GPU_FRAMES][GPU_QUERIES]; ///< Pass measured by query
+    int gpuCount[GPU_FRAMES];             ///< Amount of used queries of frame
+    double gpuTime[GPU_FRAMES];           ///< CPU time of frame start
+    int gpuFrame;                         ///< Index of current frame in pool
+    int gpuCurrentPass;                   ///< Measured pass or -1
+    bool gpuMeasuring;                    ///< Query is active
+    bool gpuReady;                        ///< Pool of queries was generated
+    resolution dynamicResolution;         ///< Controller of render scale
+    GLuint particleBuffer;                ///< VBO with billboards of particle batch
+    float* particleBillboard;             ///< Texture coords stored in particle VBO
     shader* current;                      ///< Current binded shader
     glsl* scene;                          ///< Scene shader
     glsl* shadow;                         ///< Special shader for shadow
+    glsl* blob;                           ///< Shader for blob shadows
     bool oddFrame;                        ///< Odd frame info
+    float rttScale[2];                    ///< Render scale used for content of each FBO
     bool rttComplete;                     ///< Information if fbo is complete
     unsigned int* rendertexture;          ///< Texture for color buffer
     unsigned int* fboID;                  ///< Frame buffer object id
@@ -49,6 +71,27 @@ public:
      */
     ~gles20();
 
+    /**
+     * @brief adaptResolution changes render scale inside FBO by measured frame time
+     * @param frameTime is measured GPU time of frame in milliseconds
+     */
+    void adaptResolution(float frameTime);
+
+    /**
+     * @brief createShader creates GLSL shader
+     * @param vert is vertex shader code
+     * @param frag is fragment shader code
+     * @return shader instance
+     */
+    shader* createShader(std::vector<std::string> vert, std::vector<std::string> frag);
+
+    /**
+     * @brief createTexture creates OpenGL texture
+     * @param raster is texture raster instance, it is released
+     * @return texture instance
+     */
+    texture* createTexture(Texture raster);
+
     /**
      * @brief init inits renderer
      * @param w is screen width
@@ -72,12 +115,31 @@ public:
      */
     void renderModel(model* m);
 
+    /**
+     * @brief renderParticles renders billboard for every particle
+     * @param x is array of particle x coordinates
+     * @param y is array of particle y coordinates
+     * @param z is array of particle z coordinates
+     * @param count is amount of particles
+     * @param sh is shader which places billboard by particle index
+     * @param billboard is model of one billboard with texture
+     */
+    void renderParticles(float* x, float* y, float* z, int count, shader* sh, model3d* billboard);
+
     /**
      * @brief renderShadow renders shadow of model into scene
      * @param m is instance of model to render
      */
     void renderShadow(model* m);
 
+    /**
+     * @brief renderShadows renders blob shadows under all cars in one pass
+     * @param vertices is vertices of blobs in world space
+     * @param coords is texture coords of blobs
+     * @param triangleCount is triangle count
+     */
+    void renderShadows(float* vertices, float* coords, int triangleCount);
+
     /**
      * @brief renderSubModel renders model into scene
      * @param m is instance of model to render
@@ -90,8 +152,52 @@ public:
      */
     void rtt(bool enable);
 
+    /**
+     * @brief setDynamicResolution enables changing render scale, scale from init is maximum
+     * @param frameTime is wanted GPU time of frame in milliseconds, 0 disables it
+     * @param minAliasing is the lowest allowed render scale
+     */
+    void setDynamicResolution(float frameTime, float minAliasing);
+
+protected:
+
+    /**
+     * @brief applyState applies one change of render state into OpenGL
+     * @param type is one of STATE_ defines
+     * @param value is new value of state
+     */
+    void applyState(int type, int value);
+
 private:
+
+    /**
+     * @brief beginPass starts measuring of GPU pass if it differs from current one
+     * @param pass is GPU_PASS_SCENE, GPU_PASS_SHADOW, GPU_PASS_EFFECTS or GPU_PASS_COMPOSITE
+     */
+    void beginPass(int pass);
+
+    /**
+     * @brief cleanup deletes GL objects
+     */
     void cleanup();
+
+    /**
+     * @brief endPass finishes measuring of current GPU pass
+     */
+    void endPass();
+
+    /**
+     * @brief readPasses passes results of finished frame into profiler without waiting
+     * @param frame is index of frame in pool
+     */
+    void readPasses(int frame);
+
+    /**
+     * @brief uniformFrame sends placement of current animation frame in atlas into shader
+     * @param sh is bound shader
+     * @param txt is texture to use
+     */
+    void uniformFrame(shader* sh, texture* txt);
 };
 
 #endif // GLES20_H
@@ -9,15 +9,21 @@
 
 #include <stdint.h>
 #include "engine/io.h"
+#include "engine/profiler.h"
 #include "renderers/opengl/gles20.h"
 #include "renderers/opengl/glsl.h"
+#include "renderers/opengl/programcache.h"
 
 glsl::~glsl()
 {
-    glDetachShader(id, shader_vp);
-    glDetachShader(id, shader_fp);
-    glDeleteShader(shader_vp);
-    glDeleteShader(shader_fp);
+    /// program loaded from cache has no shader objects
+    if (shader_vp)
+    {
+        glDetachShader(id, shader_vp);
+        glDetachShader(id, shader_fp);
+        glDeleteShader(shader_vp);
+        glDeleteShader(shader_fp);
+    }
     glUseProgram(0);
     glDeleteProgram(id);
 }
@@ -29,6 +35,7 @@ glsl::~glsl()
  */
 glsl::glsl(std::vector<std::string> vert, std::vector<std::string> frag)
 {
+    PROFILE("glsl::glsl");
     instanceCount = 1;
 
     /// convert vertex shader source code
@@ -127,6 +134,13 @@ void glsl::bind()
  */
 unsigned int glsl::initShader(const char *vs, const char *fs)
 {
+    /// Use linked binary from previous run
+    shader_vp = 0;
+    shader_fp = 0;
+    unsigned int cached = programcache::load(vs, fs);
+    if (cached)
+        return cached;
+
     /// Load shader
     shader_vp = glCreateShader(GL_VERTEX_SHADER);
     shader_fp = glCreateShader(GL_FRAGMENT_SHADER);
@@ -153,6 +167,7 @@ unsigned int glsl::initShader(const char *vs, const char *fs)
     unsigned int shader_id = glCreateProgram();
     glAttachShader(shader_id, shader_fp);
     glAttachShader(shader_id, shader_vp);
+    programcache::prepare(shader_id);
     glLinkProgram(shader_id);
     glGetProgramInfoLog(shader_id, BUFFER_SIZE, &length, buffer);
     if (length > 0)
@@ -164,6 +179,8 @@ unsigned int glsl::initShader(const char *vs, const char *fs)
     glGetProgramiv(shader_id, GL_LINK_STATUS, &status);
     if (status == GL_FALSE)
         logi("GLSL error linking", "buffer");
+    else
+        programcache::save(shader_id, vs, fs);
     return shader_id;
 }
 
@@ -195,6 +212,17 @@ void glsl::uniformFloat(const char* name, float value)
     glUniform1f(glGetUniformLocation(id, name), value);
 }
 
+/**
+ * @brief uniformFloat3v send array of vec3 into shader
+ * @param name is uniform name
+ * @param values is array of vector values
+ * @param count is amount of vectors
+ */
+void glsl::uniformFloat3v(const char* name, float* values, int count)
+{
+    glUniform3fv(glGetUniformLocation(id, name), count, values);
+}
+
 /**
  * @brief uniformFloat4 send vec4 into shader
  * @param name is uniform name
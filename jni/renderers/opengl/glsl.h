@@ -78,6 +78,14 @@ public:
      */
     void uniformFloat(const char* name, float value);
 
+    /**
+     * @brief uniformFloat3v send array of vec3 into shader
+     * @param name is uniform name
+     * @param values is array of vector values
+     * @param count is amount of vectors
+     */
+    void uniformFloat3v(const char* name, float* values, int count);
+
     /**
      * @brief uniformFloat4 send vec4 into shader
      * @param name is uniform name
@@ -8,6 +8,7 @@
 ///----------------------------------------------------------------------------------------
 
 #include <stdio.h>
+#include "engine/profiler.h"
 #include "renderers/opengl/gles20.h"
 #include "renderers/opengl/gltexture.h"
 
@@ -16,39 +17,8 @@
  */
 gltexture::~gltexture()
 {
-    if (!animated)
-    {
-        if (data)
-            delete[] data;
-        glDeleteTextures(1, &textureID);
-    }
-    else
-    {
-        for (int i = anim.size() - 1; i >= 0; i--)
-            delete anim[i];
-    }
-}
-
-/**
- * @brief gltexture creates animated empty texture instance
- * @param anim is an image sequence
- */
-gltexture::gltexture(std::vector<texture*> anim)
-{
-    this->anim = anim;
-    transparent = true;
-    animated = true;
-    instanceCount = 1;
-
-    /// set animation speed
-    multiFrame = anim.size() / 50;
-    if (anim.size() < 10)
-        multiFrame = 3;
-    if (multiFrame < 1)
-        multiFrame = 1;
-
-    currentFrame = 0;
-    currentMultiFrame = 0;
+    pngdecoder::release(data, twidth * theight * (hasAlpha ? 4 : 3));
+    glDeleteTextures(1, &textureID);
 }
 
 /**
@@ -62,9 +32,9 @@ gltexture::gltexture(Texture texture)
     twidth = texture.width;
     theight = texture.height;
     transparent = texture.hasAlpha;
-    animated = false;
     data = texture.data;
     hasAlpha = texture.hasAlpha;
+    setFrames(1, 1, 1);
 }
 
 /**
@@ -72,28 +42,25 @@ gltexture::gltexture(Texture texture)
  */
 void gltexture::apply()
 {
-    if (animated)
+    /// upload texture
+    if (data)
     {
-        anim[currentFrame]->apply();
+        PROFILE("gltexture::upload");
+        glGenTextures(1, &textureID);
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, textureID);
 
-        /// update animation
-        currentMultiFrame++;
-        if (currentMultiFrame == multiFrame)
+        //Frames of atlas are clamped and not mipmapped, lower levels would mix them together
+        bool atlas = frameCount > 1;
+        if (atlas)
         {
-            currentMultiFrame = 0;
-            currentFrame++;
+            glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+            glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+            glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+            glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
         }
-        if (currentFrame == anim.size())
-            currentFrame = 0;
-    } else
-    {
-        /// upload texture
-        if (data)
+        else
         {
-            glGenTextures(1, &textureID);
-            glEnable(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, textureID);
-
             //And if you go and use extensions, you can use Anisotropic filtering textures which are of an
             //even better quality, but this will do for now.
             glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
@@ -103,25 +70,18 @@ void gltexture::apply()
             //to the edge of our shape.
             glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
             glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
-            if (hasAlpha)
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, twidth, theight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-            else
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, twidth, theight, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        }
+        if (hasAlpha)
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, twidth, theight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        else
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, twidth, theight, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        if (!atlas)
             glGenerateMipmap(GL_TEXTURE_2D);
 
-            delete[] data;
-            data = 0;
-        }
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        pngdecoder::release(data, twidth * theight * (hasAlpha ? 4 : 3));
+        data = 0;
     }
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, textureID);
 }
 
-/**
- * @brief setFrame set frame of animation
- * @param frame is index of frame
- */
-void gltexture::setFrame(int frame)
-{
-    currentFrame = frame;
-}
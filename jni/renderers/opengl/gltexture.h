@@ -16,23 +16,11 @@
 class gltexture : public texture
 {
 public:
-    bool animated;                  ///< True if it is texture sequence
-    std::vector<texture*> anim;     ///< Animation images
-    unsigned int currentFrame;      ///< Current image
-    unsigned int currentMultiFrame; ///< Replying frames state
-    unsigned int multiFrame;        ///< Replying frames amount
-
     /**
      * @brief destruct removes texture from memory
      */
     ~gltexture();
 
-    /**
-     * @brief gltexture creates animated empty texture instance
-     * @param anim is an image sequence
-     */
-    gltexture(std::vector<texture*> anim);
-
     /**
      * @brief gltexture creates texture from raster data
      * @param texture is texture raster instance
@@ -43,12 +31,6 @@ public:
      * @brief apply applies current texture
      */
     void apply();
-
-    /**
-     * @brief setFrame set frame of animation
-     * @param frame is index of frame
-     */
-    void setFrame(int frame);
 private:
     bool hasAlpha;
     unsigned char* data;
@@ -0,0 +1,202 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       programcache.cpp
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Cache of linked shader programs on disk, programs are stored as driver
+ *             binaries keyed by hash of shader source and driver identification.
+**/
+///----------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "engine/io.h"
+#include "renderers/opengl/gles20.h"
+#include "renderers/opengl/programcache.h"
+
+#ifdef ANDROID
+#include <EGL/egl.h>
+#define GL_NUM_PROGRAM_BINARY_FORMATS GL_NUM_PROGRAM_BINARY_FORMATS_OES
+#define GL_PROGRAM_BINARY_LENGTH GL_PROGRAM_BINARY_LENGTH_OES
+#define PROGRAM_BINARY_EXTENSION "GL_OES_get_program_binary"
+#else
+#define PROGRAM_BINARY_EXTENSION "GL_ARB_get_program_binary"
+#define getProgramBinary glGetProgramBinary
+#define programBinary glProgramBinary
+#endif
+
+#define HASH_OFFSET 14695981039346656037ULL
+#define HASH_PRIME 1099511628211ULL
+
+std::string cacheDirectory;     ///< Directory of cached binaries
+int cacheSupported = -1;        ///< Driver support of binaries, -1 if it was not checked
+unsigned long long cacheDriver; ///< Hash of driver identification
+#ifdef ANDROID
+PFNGLGETPROGRAMBINARYOESPROC getProgramBinary = 0;  ///< Extension function
+PFNGLPROGRAMBINARYOESPROC programBinary = 0;        ///< Extension function
+#endif
+
+/**
+ * @brief programHash adds string into FNV-1a hash
+ * @param value is hash to update
+ * @param text is added string
+ * @return updated hash
+ */
+unsigned long long programHash(unsigned long long value, const char* text)
+{
+    for (; text && *text; text++)
+    {
+        value ^= (unsigned char)*text;
+        value *= HASH_PRIME;
+    }
+    return value;
+}
+
+/**
+ * @brief load creates program from cached binary
+ * @param vs is vertex shader code
+ * @param fs is fragment shader code
+ * @return linked program id or 0 if it is not cached
+ */
+unsigned int programcache::load(const char* vs, const char* fs)
+{
+    std::string filename = getFilename(vs, fs);
+    if (filename.empty())
+        return 0;
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return 0;
+
+    /// file contains binary format, binary length and binary
+    int header[2] = {0, 0};
+    std::vector<char> binary;
+    if (fread(header, sizeof(int), 2, file) == 2 && (header[1] > 0))
+    {
+        binary.resize(header[1]);
+        if (fread(&binary[0], 1, header[1], file) != (size_t)header[1])
+            binary.clear();
+    }
+    fclose(file);
+    if (binary.empty())
+        return 0;
+
+    /// binary is refused after driver update, program is compiled from source then
+    unsigned int program = glCreateProgram();
+    programBinary(program, header[0], &binary[0], header[1]);
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE)
+    {
+        glDeleteProgram(program);
+        remove(filename.c_str());
+        return 0;
+    }
+    return program;
+}
+
+/**
+ * @brief prepare marks program before linking so its binary can be read later
+ * @param program is program id
+ */
+void programcache::prepare(unsigned int program)
+{
+#ifndef ANDROID
+    if (!cacheDirectory.empty() && isSupported())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+}
+
+/**
+ * @brief save stores binary of linked program
+ * @param program is linked program id
+ * @param vs is vertex shader code
+ * @param fs is fragment shader code
+ */
+void programcache::save(unsigned int program, const char* vs, const char* fs)
+{
+    std::string filename = getFilename(vs, fs);
+    if (filename.empty())
+        return;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    getProgramBinary(program, length, &length, &format, &binary[0]);
+    if (length <= 0)
+        return;
+
+    /// file is renamed when complete, so another run never reads half written binary
+    std::string temp = filename + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file)
+    {
+        loge("Unable to write program cache:", temp);
+        return;
+    }
+    int header[2] = {(int)format, length};
+    bool ok = fwrite(header, sizeof(int), 2, file) == 2;
+    ok = ok && (fwrite(&binary[0], 1, length, file) == (size_t)length);
+    fclose(file);
+    if (!ok || (rename(temp.c_str(), filename.c_str()) != 0))
+        remove(temp.c_str());
+}
+
+/**
+ * @brief setDirectory sets where binaries are stored, empty path disables cache
+ * @param path is path of writable directory
+ */
+void programcache::setDirectory(std::string path)
+{
+    cacheDirectory = path;
+}
+
+/**
+ * @brief getFilename gets cache file of program
+ * @param vs is vertex shader code
+ * @param fs is fragment shader code
+ * @return path of file or empty string if cache is not supported
+ */
+std::string programcache::getFilename(const char* vs, const char* fs)
+{
+    if (cacheDirectory.empty() || !isSupported())
+        return "";
+
+    /// name is hash of driver and both sources
+    unsigned long long value = programHash(programHash(cacheDriver, vs), "\n--\n");
+    value = programHash(value, fs);
+    char name[32];
+    sprintf(name, "/%016llx.glbin", value);
+    return cacheDirectory + name;
+}
+
+/**
+ * @brief isSupported checks once with graphical context if driver supports binaries
+ * @return true if cache could be used
+ */
+bool programcache::isSupported()
+{
+    if (cacheSupported < 0)
+    {
+        /// extension is checked first, its functions must not be called without it
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        GLint formats = 0;
+        if (extensions && strstr(extensions, PROGRAM_BINARY_EXTENSION))
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+#ifdef ANDROID
+        getProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+        programBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+        if (!getProgramBinary || !programBinary)
+            formats = 0;
+#endif
+        cacheSupported = formats > 0 ? 1 : 0;
+        if (!cacheSupported)
+            loge("Program cache disabled, missing", PROGRAM_BINARY_EXTENSION);
+        cacheDriver = programHash(HASH_OFFSET, (const char*)glGetString(GL_VENDOR));
+        cacheDriver = programHash(cacheDriver, (const char*)glGetString(GL_RENDERER));
+        cacheDriver = programHash(cacheDriver, (const char*)glGetString(GL_VERSION));
+    }
+    return cacheSupported == 1;
+}
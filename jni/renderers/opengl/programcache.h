@@ -0,0 +1,68 @@
+///----------------------------------------------------------------------------------------
+/**
+ * \file       programcache.h
+ * \author     Vonasek Lubos
+ * \date       2026/10/18
+ * \brief      Cache of linked shader programs on disk, programs are stored as driver
+ *             binaries keyed by hash of shader source and driver identification.
+**/
+///----------------------------------------------------------------------------------------
+
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <string>
+
+/**
+ * @brief The program cache class
+ */
+class programcache
+{
+public:
+
+    /**
+     * @brief load creates program from cached binary
+     * @param vs is vertex shader code
+     * @param fs is fragment shader code
+     * @return linked program id or 0 if it is not cached
+     */
+    static unsigned int load(const char* vs, const char* fs);
+
+    /**
+     * @brief prepare marks program before linking so its binary can be read later
+     * @param program is program id
+     */
+    static void prepare(unsigned int program);
+
+    /**
+     * @brief save stores binary of linked program
+     * @param program is linked program id
+     * @param vs is vertex shader code
+     * @param fs is fragment shader code
+     */
+    static void save(unsigned int program, const char* vs, const char* fs);
+
+    /**
+     * @brief setDirectory sets where binaries are stored, empty path disables cache
+     * @param path is path of writable directory
+     */
+    static void setDirectory(std::string path);
+
+private:
+
+    /**
+     * @brief getFilename gets cache file of program
+     * @param vs is vertex shader code
+     * @param fs is fragment shader code
+     * @return path of file or empty string if cache is not supported
+     */
+    static std::string getFilename(const char* vs, const char* fs);
+
+    /**
+     * @brief isSupported checks once with graphical context if driver supports binaries
+     * @return true if cache could be used
+     */
+    static bool isSupported();
+};
+
+#endif // PROGRAMCACHE_H
@@ -12,6 +12,9 @@ import com.lvonasek.o4s.R;
 import com.lvonasek.o4s.media.Settings;
 import com.lvonasek.o4s.media.Sound;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.FloatBuffer;
 import java.util.ArrayList;
 
 import javax.microedition.khronos.egl.EGLConfig;
@@ -43,6 +46,27 @@ public class GameLoop extends GLSurfaceView implements Renderer {
     public static final int CAR_INFO_SNDN2O = 16;
     public static final int CAR_INFO_SNDRATE = 17;
     public static final int CAR_INFO_TOFINISH = 18;
+    public static final int CAR_INFO_PLACE = 19;
+    public static final int CAR_INFO_COUNT = 20;
+
+    //Telemetry buffer layout
+    public static final int TELEMETRY_VERSION = 0;
+    public static final int TELEMETRY_CARS = 1;
+    public static final int TELEMETRY_STRIDE = 2;
+    public static final int TELEMETRY_HEADER = 3;
+
+    //Frame scheduler information
+    public static final int FRAME_STATS_TARGET_TICKS = 0;
+    public static final int FRAME_STATS_TARGET_FPS = 1;
+    public static final int FRAME_STATS_TICKS = 2;
+    public static final int FRAME_STATS_FPS = 3;
+    public static final int FRAME_STATS_TIME_P50 = 4;
+    public static final int FRAME_STATS_TIME_P90 = 5;
+    public static final int FRAME_STATS_TIME_P99 = 6;
+
+    //Dynamic resolution keeps rendering time under this value in milliseconds
+    public static final float RESOLUTION_FRAME_TIME = 40;
+    public static final float RESOLUTION_MIN = 0.25f;
 
     //Game state
     public int            currentPlace = 0;
@@ -50,8 +74,10 @@ public class GameLoop extends GLSurfaceView implements Renderer {
     // instance of sounds
     private static ArrayList<Sound> sounds;
 
+    //snapshot of all cars written by native code every tick
+    private FloatBuffer telemetry;
+
     //fps counter
-    private int currentFPS;
     private long updateFPS;
 
     /**
@@ -105,6 +131,7 @@ public class GameLoop extends GLSurfaceView implements Renderer {
             apkFilePath = appInfo.sourceDir;
             float quality = 0.01f * Settings.getConfig(GameActivity.instance, Settings.VISUAL_QUALITY);
             quality = 0.25f + 0.75f * quality;
+            shaderCache(GameActivity.instance.getCacheDir().getAbsolutePath());
             int event = Settings.getConfig(GameActivity.instance, Settings.RACE_EVENT);
             if (event >= 0)
                 init(apkFilePath, RaceInfo.EVENT[event].race, quality);
@@ -112,6 +139,11 @@ public class GameLoop extends GLSurfaceView implements Renderer {
                 String path = Settings.getConfig(GameActivity.instance, Settings.RACE_CUSTOM_EVENT);
                 init(apkFilePath, path, quality);
             }
+            ByteBuffer buffer = ByteBuffer.allocateDirect(4 * (TELEMETRY_HEADER + carCount() * CAR_INFO_COUNT));
+            buffer.order(ByteOrder.nativeOrder());
+            telemetry(buffer);
+            telemetry = buffer.asFloatBuffer();
+            resolution(RESOLUTION_FRAME_TIME, RESOLUTION_MIN);
             GameActivity.instance.finishLoading();
         }
         GameActivity.init = true;
@@ -140,25 +172,23 @@ public class GameLoop extends GLSurfaceView implements Renderer {
         //check if game is not paused
         if (paused <= 0) {
             paused = 0;
-            long time = System.currentTimeMillis();
-            display();
-            loop();
-            update();
+            //native code sleeps until next frame without holding lock, then does due ticks
+            int ticks = waitFrame();
+            frame(ticks);
+            //snapshot with one-shot events like crash sound is new only after ticks
+            if (ticks > 0)
+                update();
 
-            currentFPS++;
             if (updateFPS + 1000 < System.currentTimeMillis()) {
                 updateFPS = System.currentTimeMillis();
-                final int FPS = currentFPS;
+                final int FPS = Math.round(frameStats(FRAME_STATS_FPS));
                 GameActivity.instance.runOnUiThread(new Runnable() {
                     @Override
                     public void run() {
                         GameActivity.instance.fpsCounter.setText("FPS:" + FPS);
                     }
                 });
-                currentFPS = 0;
             }
-
-            while (System.currentTimeMillis() - time < 50) {}
         } else
             display();
     }
@@ -166,11 +196,11 @@ public class GameLoop extends GLSurfaceView implements Renderer {
     public void update() {
         int count = 1;//carCount();
         for (int i = 0; i < count; i++) {
-            boolean crash = carState(i, CAR_INFO_SNDCRASH) > 0.5f;
-            float dist = carState(i, CAR_INFO_SNDDIST);
-            float engine1 = carState(i, CAR_INFO_SNDENGINE1);
-            float engine2 = carState(i, CAR_INFO_SNDENGINE2);
-            float rate = carState(i, CAR_INFO_SNDRATE);
+            boolean crash = carInfo(i, CAR_INFO_SNDCRASH) > 0.5f;
+            float dist = carInfo(i, CAR_INFO_SNDDIST);
+            float engine1 = carInfo(i, CAR_INFO_SNDENGINE1);
+            float engine2 = carInfo(i, CAR_INFO_SNDENGINE2);
+            float rate = carInfo(i, CAR_INFO_SNDRATE);
             if (dist > 0.1f) {
                 if (crash)
                     sounds.get(0 + i * 3).play();
@@ -186,17 +216,13 @@ public class GameLoop extends GLSurfaceView implements Renderer {
             }
         }
 
-        //update HUD
+        //update HUD, snapshot is copied on GL thread which writes it
+        final float[] info = carSnapshot(0);
         GameActivity.instance.runOnUiThread(new Runnable() {
             @Override
             public void run() {
-                int count = carCount();
-                int place = 1;
-                float distance = carState(0, CAR_INFO_TOFINISH);
-                for (int i = 1; i < count; i++) {
-                    if (distance > carState(i, CAR_INFO_TOFINISH))
-                        place++;
-                }
+                int place = (int)info[CAR_INFO_PLACE];
+                float distance = info[CAR_INFO_TOFINISH];
                 int dst = Math.max(0, (int)(distance * 0.01));
                 String placeText = "";
                 switch(place) {
@@ -219,7 +245,7 @@ public class GameLoop extends GLSurfaceView implements Renderer {
                         placeText = GameActivity.instance.getString(R.string.hud_6th);
                         break;
                 }
-                int speed = (int)carState(0, CAR_INFO_SPEED);
+                int speed = (int)info[CAR_INFO_SPEED];
                 GameActivity.infopanel[0].setText(placeText);
                 GameActivity.infopanel[1].setText(speed + GameActivity.instance.getString(R.string.hud_kmh));
                 GameActivity.infopanel[2].setText((dst / 10) + "." + (dst % 10) + GameActivity.instance.getString(R.string.hud_km));
@@ -256,16 +282,56 @@ public class GameLoop extends GLSurfaceView implements Renderer {
         });
     }
 
+    /**
+     * Get information about car from the last snapshot without calling native code
+     * @param index is index of car
+     * @param type is CAR_INFO type of information
+     * @return value of information or 0 if it is not available
+     */
+    public float carInfo(int index, int type) {
+        if ((telemetry == null) || (index >= (int)telemetry.get(TELEMETRY_CARS)))
+            return 0;
+        int stride = (int)telemetry.get(TELEMETRY_STRIDE);
+        if (type >= stride)
+            return 0;
+        return telemetry.get(TELEMETRY_HEADER + index * stride + type);
+    }
+
+    /**
+     * Copy all information about car from the last snapshot, it has to be called on GL thread
+     * which writes snapshots, the copy can be passed to another thread
+     * @param index is index of car
+     * @return array indexed by CAR_INFO type
+     */
+    public float[] carSnapshot(int index) {
+        float[] output = new float[CAR_INFO_COUNT];
+        for (int i = 0; i < CAR_INFO_COUNT; i++)
+            output[i] = carInfo(index, i);
+        return output;
+    }
+
     //C++ methods
     public synchronized native int carCount();
+    public synchronized native int carPlace(int index);
     public synchronized native float carState(int index, int type);
     public synchronized native void init(String apkFilePath, String track, float aliasing);
     public synchronized native void key(int code);
     public synchronized native void keyUp(int code);
     public synchronized native void display();
+    public synchronized native void frame(int ticks);
+    public synchronized native void frameRate(float tickRate, float renderRate);
+    public synchronized native float frameStats(int type);
     public synchronized native void loop();
+    public synchronized native int profileCount();
+    public synchronized native boolean profileExport(String path);
+    public synchronized native String profileName(int index);
+    public synchronized native float profileTime(int index);
     public synchronized native void resize(int w, int h);
+    public synchronized native void resolution(float frameTime, float minAliasing);
     public synchronized native void restart();
+    public synchronized native void shaderCache(String path);
+    public synchronized native void telemetry(ByteBuffer buffer);
     public synchronized native void unload();
     public synchronized native void unlock();
+    public native int waitFrame();
 }
\ No newline at end of file